@@ -42,10 +42,14 @@
  
  /* Scheduler Related */
  #define configUSE_PREEMPTION                    1
- #define configUSE_TICKLESS_IDLE                 0
+ #define configUSE_TICKLESS_IDLE                 1
+ /* Tickless idle only while the night power profile is active (lib/power). */
+ #define configPRE_SUPPRESS_TICKS_AND_SLEEP_PROCESSING( x ) \
+     do { extern volatile uint8_t power_tickless_enabled; if( !power_tickless_enabled ) ( x ) = 0; } while( 0 )
  #define configUSE_IDLE_HOOK                     0
  #define configUSE_TICK_HOOK                     0
  #define configTICK_RATE_HZ                      ( ( TickType_t ) 1000 )
+ /* SysTick counts clk_sys: lib/power re-runs vPortSetupTimerInterrupt after every clock switch. */
  #define configMAX_PRIORITIES                    32
  #define configMINIMAL_STACK_SIZE                ( configSTACK_DEPTH_TYPE ) 256
  #define configUSE_16_BIT_TICKS                  0
@@ -75,12 +79,15 @@
  #define configAPPLICATION_ALLOCATED_HEAP        0
  
  /* Hook function related definitions. */
- #define configCHECK_FOR_STACK_OVERFLOW          0
+ #define configCHECK_FOR_STACK_OVERFLOW          2
  #define configUSE_MALLOC_FAILED_HOOK            0
  #define configUSE_DAEMON_TASK_STARTUP_HOOK      0
  
  /* Run time and task stats gathering related definitions. */
- #define configGENERATE_RUN_TIME_STATS           0
+ #define configGENERATE_RUN_TIME_STATS           1
+ /* Run time counter: RP2040 1 MHz timer (lower word, read without latching). */
+ #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+ #define portGET_RUN_TIME_COUNTER_VALUE()        ( timer_hw->timerawl )
  #define configUSE_TRACE_FACILITY                1
  #define configUSE_STATS_FORMATTING_FUNCTIONS    0
  
@@ -111,6 +118,9 @@
  #define configSUPPORT_PICO_TIME_INTEROP         1
  
  #include <assert.h>
+ #ifndef __ASSEMBLER__
+ #include "hardware/structs/timer.h"
+ #endif
  /* Define to trap errors during development. */
  #define configASSERT(x)                         assert(x)
  
@@ -134,5 +144,9 @@
  #define INCLUDE_xQueueGetMutexHolder            1
  
  /* A header file that defines trace macro can be included here. */
+ /* Switch-in instant of the running task: its execution time is the run time counter plus the
+    slice in progress (deadline monitor WCET measurement, src/main.c). */
+ #define traceTASK_SWITCHED_IN() \
+     do { extern volatile uint32_t task_switched_in_us; task_switched_in_us = timer_hw->timerawl; } while( 0 )
  
  #endif /* FREERTOS_CONFIG_H */
\ No newline at end of file
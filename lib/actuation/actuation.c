@@ -0,0 +1,121 @@
+#include "actuation.h"
+#include "hardware/sync.h"
+#include "log/log.h"
+
+static actuation_timing_t timing;
+static actuation_stats_t stats;
+
+// Fila circular com o instante de cada chamada de pedestre pendente
+static uint32_t call_queue[ACTUATION_CALL_QUEUE_SIZE];
+static volatile uint8_t call_head = 0;
+static volatile uint8_t call_count = 0;
+
+static volatile uint32_t last_vehicle_call_ms = 0;
+
+// Inicializa o controle atuado com os tempos de fase informados.
+void actuation_init(const actuation_timing_t *config)
+{
+    timing = *config;
+    stats = (actuation_stats_t){0};
+    call_head = 0;
+    call_count = 0;
+    last_vehicle_call_ms = 0;
+}
+
+// Enfileira uma chamada de pedestre (botão ou detector simulado).
+void actuation_pedestrian_call(uint32_t now_ms)
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+    if (call_count < ACTUATION_CALL_QUEUE_SIZE)
+    {
+        call_queue[(call_head + call_count) % ACTUATION_CALL_QUEUE_SIZE] = now_ms;
+        call_count++;
+    }
+    else
+    {
+        stats.dropped_calls++;
+    }
+    restore_interrupts(irq_state);
+}
+
+// Registra a presença de um veículo no detector, prolongando a fase veicular.
+void actuation_vehicle_call(uint32_t now_ms)
+{
+    last_vehicle_call_ms = now_ms;
+}
+
+bool actuation_has_pedestrian_call()
+{
+    return call_count > 0;
+}
+
+// Atende todas as chamadas enfileiradas e registra a latência de cada uma.
+static void serve_pedestrian_calls(uint32_t now_ms)
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+    uint8_t count = call_count;
+    uint32_t served[ACTUATION_CALL_QUEUE_SIZE];
+    for (uint8_t i = 0; i < count; i++)
+        served[i] = call_queue[(call_head + i) % ACTUATION_CALL_QUEUE_SIZE];
+    call_head = (call_head + count) % ACTUATION_CALL_QUEUE_SIZE;
+    call_count = 0;
+    restore_interrupts(irq_state);
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        uint32_t latency = now_ms - served[i];
+        stats.served_calls++;
+        stats.last_latency_ms = latency;
+        stats.sum_latency_ms += latency;
+        if (latency > stats.max_latency_ms)
+            stats.max_latency_ms = latency;
+        LOG1(LOG_PEDESTRIAN_SERVED, latency);
+    }
+}
+
+// Decide o próximo estado do semáforo respeitando verde mínimo, limpeza e gap-out.
+int actuation_next_state(int state, uint32_t state_start_ms, uint32_t now_ms)
+{
+    uint32_t elapsed = now_ms - state_start_ms;
+
+    switch (state)
+    {
+    case PHASE_WALK:
+        if (elapsed >= timing.walk_ms)
+            return PHASE_CLEARANCE;
+        break;
+
+    case PHASE_CLEARANCE:
+        if (elapsed >= timing.clearance_ms)
+            return PHASE_VEHICLE;
+        break;
+
+    case PHASE_VEHICLE:
+        // Sem chamada de pedestre, a fase veicular repousa em verde.
+        if (!actuation_has_pedestrian_call() || elapsed < timing.min_vehicle_green_ms)
+            break;
+
+        // Detecções recentes prolongam o verde veicular até o verde máximo.
+        uint32_t gap = now_ms - last_vehicle_call_ms;
+        if (gap >= timing.vehicle_gap_ms || elapsed >= timing.max_vehicle_green_ms)
+        {
+            if (gap >= timing.vehicle_gap_ms)
+                stats.gap_outs++;
+            else
+                stats.max_outs++;
+            serve_pedestrian_calls(now_ms);
+            return PHASE_WALK;
+        }
+        break;
+    }
+
+    return state;
+}
+
+// Copia as estatísticas de latência e encerramento de fase.
+void actuation_get_stats(actuation_stats_t *out)
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+    *out = stats;
+    restore_interrupts(irq_state);
+}
@@ -0,0 +1,43 @@
+#ifndef ACTUATION_H
+#define ACTUATION_H
+
+#include <stdlib.h>
+#include "pico/stdlib.h"
+
+#define VEHICLE_DETECTOR_PIN 22       // GPIO do botão do joystick, usado como laço detector simulado
+#define ACTUATION_TICK_MS 50          // Período de avaliação do motor de fases no modo atuado
+#define ACTUATION_CALL_QUEUE_SIZE 8   // Número máximo de chamadas de pedestre enfileiradas
+
+// Estados do semáforo de pedestres (mesma convenção de light_state)
+#define PHASE_WALK 0      // Verde: pedestre pode atravessar
+#define PHASE_CLEARANCE 1 // Amarelo: intervalo de limpeza
+#define PHASE_VEHICLE 2   // Vermelho: fase veicular
+
+typedef struct actuation_timing_t
+{
+    uint32_t walk_ms;              // Duração do verde de pedestres
+    uint32_t clearance_ms;         // Duração do amarelo (limpeza da travessia)
+    uint32_t min_vehicle_green_ms; // Verde veicular mínimo antes de atender uma chamada
+    uint32_t vehicle_gap_ms;       // Intervalo sem detecção que encerra a fase veicular (gap-out)
+    uint32_t max_vehicle_green_ms; // Verde veicular máximo com chamada de pedestre pendente
+} actuation_timing_t;
+
+typedef struct actuation_stats_t
+{
+    uint32_t served_calls;    // Chamadas de pedestre atendidas
+    uint32_t dropped_calls;   // Chamadas descartadas por fila cheia
+    uint32_t last_latency_ms; // Latência chamada-verde da última chamada atendida
+    uint32_t max_latency_ms;  // Maior latência observada
+    uint64_t sum_latency_ms;  // Soma das latências (para a média)
+    uint32_t gap_outs;        // Fases veiculares encerradas por ausência de veículos
+    uint32_t max_outs;        // Fases veiculares encerradas pelo verde máximo
+} actuation_stats_t;
+
+void actuation_init(const actuation_timing_t *timing);
+void actuation_pedestrian_call(uint32_t now_ms);
+void actuation_vehicle_call(uint32_t now_ms);
+bool actuation_has_pedestrian_call();
+int actuation_next_state(int state, uint32_t state_start_ms, uint32_t now_ms);
+void actuation_get_stats(actuation_stats_t *stats);
+
+#endif // ACTUATION_H
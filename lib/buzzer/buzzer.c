@@ -1,34 +1,82 @@
 #include "buzzer.h"
 #include "hardware/pwm.h"
 #include "hardware/clocks.h"
+#include "profiler/xip_profiler.h"
 
-// Inicializa o PWM no pino do buzzer
-int init_buzzer(uint pin, float clk_div)
+typedef struct buzzer_t
+{
+    uint pin;
+    uint32_t counter_hz; // Frequência do contador PWM, independente de clk_sys
+    uint frequency;      // Tom em execução (0: desligado)
+} buzzer_t;
+
+static buzzer_t buzzers[BUZZER_MAX_PINS];
+static uint8_t buzzer_count = 0;
+
+static buzzer_t *HOT_FUNC(find_buzzer)(uint pin)
+{
+    for (uint8_t i = 0; i < buzzer_count; i++)
+    {
+        if (buzzers[i].pin == pin)
+            return &buzzers[i];
+    }
+    return NULL;
+}
+
+// Inicializa o PWM no pino do buzzer com o contador na frequência informada
+int init_buzzer(uint pin, uint32_t counter_hz)
 {
     gpio_set_function(pin, GPIO_FUNC_PWM);
     uint slice_num = pwm_gpio_to_slice_num(pin);
     pwm_config config = pwm_get_default_config();
-    pwm_config_set_clkdiv(&config, clk_div); // Ajusta divisor de clock
+    pwm_config_set_clkdiv(&config, (float)clock_get_hz(clk_sys) / counter_hz); // Ajusta divisor de clock
     pwm_init(slice_num, &config, true);
     pwm_set_gpio_level(pin, 0); // Desliga o PWM inicialmente
 
+    if (!find_buzzer(pin) && buzzer_count < BUZZER_MAX_PINS)
+        buzzers[buzzer_count++] = (buzzer_t){.pin = pin, .counter_hz = counter_hz};
+
     return slice_num; // Retorna o número do slice PWM
 }
 
-// Toca uma nota com a frequência e duração especificadas
-void play_tone(uint pin, uint frequency)
+// Toca uma nota com a frequência e duração especificadas. Chamada na fronteira de fase, como stop_tone.
+void HOT_FUNC(play_tone)(uint pin, uint frequency)
 {
+    buzzer_t *buzzer = find_buzzer(pin);
+    if (!buzzer || frequency == 0)
+        return;
+
+    // O wrap depende apenas da frequência do contador, não do clk_sys nem do divisor.
     uint slice_num = pwm_gpio_to_slice_num(pin);
-    uint32_t clock_freq = clock_get_hz(clk_sys);
-    uint32_t top = clock_freq / frequency - 1;
+    uint32_t top = buzzer->counter_hz / frequency - 1;
+    if (top > 0xFFFF)
+        top = 0xFFFF;
 
     pwm_set_wrap(slice_num, top);
     pwm_set_gpio_level(pin, top / 2); // 50% de duty cycle
+    buzzer->frequency = frequency;
 }
 
 // Desliga o tom no pino do buzzer
-void stop_tone(uint pin)
+void HOT_FUNC(stop_tone)(uint pin)
 {
-    uint slice_num = pwm_gpio_to_slice_num(pin);
     pwm_set_gpio_level(pin, 0); // Desliga o PWM
-}
\ No newline at end of file
+
+    buzzer_t *buzzer = find_buzzer(pin);
+    if (buzzer)
+        buzzer->frequency = 0;
+}
+
+// Tom em execução no pino do buzzer (0: desligado)
+uint buzzer_get_tone(uint pin)
+{
+    buzzer_t *buzzer = find_buzzer(pin);
+    return buzzer ? buzzer->frequency : 0;
+}
+
+// Recalcula o divisor de cada buzzer para um novo clk_sys (observador de troca de clock).
+void buzzer_set_clock(uint32_t sys_hz)
+{
+    for (uint8_t i = 0; i < buzzer_count; i++)
+        pwm_set_clkdiv(pwm_gpio_to_slice_num(buzzers[i].pin), (float)sys_hz / buzzers[i].counter_hz);
+}
@@ -6,9 +6,22 @@
 
 #define BUZZER_A_PIN 21 // GPIO para buzzer A
 #define BUZZER_B_PIN 10 // GPIO para buzzer B
+#define BUZZER_MAX_PINS 2
 
-int init_buzzer(uint pin, float clk_div); // Inicializa o PWM no pino do buzzer
-void play_tone(uint pin, uint frequency); // Toca uma nota com a frequência e duração especificadas
-void stop_tone(uint pin);                 // Desliga o tom no pino do buzzer
+#define BUZZER_COUNTER_HZ 1000000 // Frequência do contador PWM: tons de 16 Hz a 500 kHz cabem no wrap de 16 bits
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int init_buzzer(uint pin, uint32_t counter_hz); // Inicializa o PWM no pino do buzzer
+void play_tone(uint pin, uint frequency);       // Toca uma nota com a frequência e duração especificadas
+void stop_tone(uint pin);                       // Desliga o tom no pino do buzzer
+uint buzzer_get_tone(uint pin);                 // Tom em execução no pino do buzzer (0: desligado)
+void buzzer_set_clock(uint32_t sys_hz);         // Mantém a frequência do contador após troca de clk_sys
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif // BUZZER_H
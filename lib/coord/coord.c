@@ -0,0 +1,133 @@
+#include "coord.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "log/log.h"
+
+static coord_engine_t engine;
+static coord_decoder_t decoder;
+
+// Cada byte gera uma interrupção (FIFO desligada): o carimbo do último byte marca o fim do quadro.
+static void on_uart_rx()
+{
+    while (uart_is_readable(COORD_UART))
+    {
+        uint8_t byte = uart_getc(COORD_UART);
+        coord_sync_t sync;
+        if (!coord_decode_byte(&decoder, byte, &sync))
+            continue;
+
+        uint32_t steps = engine.stats.steps;
+        coord_engine_on_sync(&engine, &sync, time_us_64());
+        if (engine.stats.steps != steps)
+            LOG2(LOG_COORD_STEP, sync.hop + 1, engine.stats.last_error_us);
+    }
+}
+
+// Configura o enlace UART e o motor de fase; o primeiro ciclo começa um ciclo nominal após agora.
+void coord_init(const coord_config_t *config, bool is_leader)
+{
+    coord_engine_init(&engine, config, is_leader, time_us_64());
+    coord_decoder_reset(&decoder);
+
+    uart_init(COORD_UART, COORD_BAUD);
+    gpio_set_function(COORD_TX_PIN, GPIO_FUNC_UART);
+    gpio_set_function(COORD_RX_PIN, GPIO_FUNC_UART);
+    uart_set_fifo_enabled(COORD_UART, false);
+
+    irq_set_exclusive_handler(COORD_UART_IRQ, on_uart_rx);
+    irq_set_enabled(COORD_UART_IRQ, true);
+    uart_set_irq_enables(COORD_UART, true, false);
+}
+
+// Recalcula o divisor da UART para um novo clk_sys (observador de troca de clock). clk_peri
+// segue clk_sys em set_sys_clock_khz, mas uart_set_baudrate leria o clock antigo quando o
+// observador roda antes da troca: o divisor é calculado aqui a partir de sys_hz, como no SDK.
+// Um byte em trânsito durante a troca pode se corromper; o CRC descarta o quadro e a trava
+// aguenta a falta de um sincronismo.
+void coord_set_clock(uint32_t sys_hz)
+{
+    uint32_t divider = 8 * sys_hz / COORD_BAUD + 1; // 1/128 de período de bit, arredondado
+    uart_get_hw(COORD_UART)->ibrd = divider >> 7;
+    uart_get_hw(COORD_UART)->fbrd = (divider & 0x7f) >> 1;
+    hw_set_bits(&uart_get_hw(COORD_UART)->lcr_h, 0); // A PL011 só aplica o divisor após escrever LCR_H
+}
+
+// Início programado do próximo ciclo (pode mudar a cada quadro de sincronismo recebido).
+uint64_t coord_next_cycle_start()
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+    uint64_t start = coord_engine_next_start(&engine);
+    restore_interrupts(irq_state);
+    return start;
+}
+
+// Descarta, em ciclos inteiros, os inícios anteriores a earliest_us que não foram executados
+// (modo noturno, modo de segurança): sem isso, coord_begin_cycle repetiria cada ciclo perdido,
+// com fronteiras já passadas e um quadro de sincronismo por ciclo.
+void coord_skip_missed_cycles(uint64_t earliest_us)
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+    uint32_t lost = engine.stats.lost;
+    uint32_t missed = coord_engine_skip_missed(&engine, earliest_us);
+    restore_interrupts(irq_state);
+
+    if (missed)
+        LOG1(LOG_COORD_SKIPPED, missed);
+    if (engine.stats.lost != lost)
+        LOG0(LOG_COORD_LOST);
+}
+
+// Fixa o início do próximo ciclo, programa o seguinte e repassa o sincronismo a jusante.
+// Retorna o instante de início, usado como fronteira da primeira fase do ciclo.
+uint64_t coord_begin_cycle()
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+    uint32_t lost = engine.stats.lost;
+    coord_engine_advance(&engine);
+    uint64_t start = engine.cycle_start_us;
+    bool should_emit = coord_engine_should_emit(&engine);
+    restore_interrupts(irq_state);
+
+    if (engine.stats.lost != lost)
+        LOG0(LOG_COORD_LOST);
+
+    if (should_emit)
+    {
+        // O quadro informa quando começou a ser enviado em relação ao início do ciclo (aqui, antes dele).
+        coord_sync_t sync;
+        uint8_t frame[COORD_FRAME_SIZE];
+        irq_state = save_and_disable_interrupts();
+        coord_engine_make_sync(&engine, time_us_64(), &sync);
+        uint8_t length = coord_encode(&sync, frame);
+        uart_putc_raw(COORD_UART, frame[0]); // Primeiro byte sai no instante carimbado
+        restore_interrupts(irq_state);
+        uart_write_blocking(COORD_UART, &frame[1], length - 1);
+    }
+
+    return start;
+}
+
+bool coord_is_locked()
+{
+    return engine.is_leader || engine.is_locked;
+}
+
+void coord_get_stats(coord_stats_t *out)
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+    *out = engine.stats;
+    restore_interrupts(irq_state);
+}
+
+// Imprime o estado da trava e o erro de fase medido nos quadros recebidos.
+void coord_report()
+{
+    coord_stats_t stats;
+    coord_get_stats(&stats);
+    uint32_t mean_us = stats.locked_syncs ? (uint32_t)(stats.sum_abs_error_us / stats.locked_syncs) : 0;
+    printf("coordenacao;papel;salto;travado;sincronismos;saltos;perdas;erro_us;erro_max_us;erro_medio_us;trim_us\n");
+    printf("%s;%u;%s;%lu;%lu;%lu;%ld;%lu;%lu;%ld\n", engine.is_leader ? "lider" : "seguidor", engine.hop,
+           coord_is_locked() ? "sim" : "nao", (unsigned long)stats.syncs, (unsigned long)stats.steps,
+           (unsigned long)stats.lost, (long)stats.last_error_us, (unsigned long)stats.max_abs_error_us,
+           (unsigned long)mean_us, (long)stats.trim_us);
+}
@@ -0,0 +1,26 @@
+#ifndef COORD_H
+#define COORD_H
+
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "hardware/uart.h"
+#include "coord_core.h"
+
+#define COORD_UART uart0
+#define COORD_UART_IRQ UART0_IRQ // Deve corresponder a COORD_UART
+#define COORD_TX_PIN 0      // Para o controlador a jusante
+#define COORD_RX_PIN 1      // Do controlador a montante
+#define COORD_BAUD 115200
+#define COORD_RX_LATENCY_US 20 // Latência fixa entre o último bit e o carimbo na interrupção
+#define COORD_LINK_DELAY_US (COORD_FRAME_SIZE * 10 * 1000000ull / COORD_BAUD + COORD_RX_LATENCY_US)
+
+void coord_init(const coord_config_t *config, bool is_leader);
+void coord_set_clock(uint32_t sys_hz);
+uint64_t coord_next_cycle_start();
+void coord_skip_missed_cycles(uint64_t earliest_us);
+uint64_t coord_begin_cycle();
+bool coord_is_locked();
+void coord_get_stats(coord_stats_t *stats);
+void coord_report();
+
+#endif // COORD_H
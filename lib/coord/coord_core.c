@@ -0,0 +1,230 @@
+#include "coord_core.h"
+
+enum
+{
+    DECODE_SYNC,
+    DECODE_CHANNEL,
+    DECODE_LENGTH,
+    DECODE_PAYLOAD,
+    DECODE_CRC,
+};
+
+// CRC-8 (polinômio 0x07), o mesmo dos quadros do log binário.
+uint8_t coord_crc8(const uint8_t *data, uint8_t length)
+{
+    uint8_t crc = 0;
+    for (uint8_t i = 0; i < length; i++)
+    {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++)
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+
+static void put_u32(uint8_t *buffer, uint32_t value)
+{
+    buffer[0] = value;
+    buffer[1] = value >> 8;
+    buffer[2] = value >> 16;
+    buffer[3] = value >> 24;
+}
+
+static uint32_t get_u32(const uint8_t *buffer)
+{
+    return buffer[0] | buffer[1] << 8 | buffer[2] << 16 | (uint32_t)buffer[3] << 24;
+}
+
+// Monta o quadro [sincronismo][canal][tamanho][carga útil][CRC-8]; retorna o tamanho.
+uint8_t coord_encode(const coord_sync_t *sync, uint8_t frame[COORD_FRAME_SIZE])
+{
+    uint8_t *payload = &frame[3];
+    frame[0] = COORD_FRAME_SYNC;
+    frame[1] = COORD_FRAME_CHANNEL;
+    frame[2] = COORD_PAYLOAD_SIZE;
+    put_u32(&payload[0], sync->cycle);
+    put_u32(&payload[4], sync->cycle_length_us);
+    put_u32(&payload[8], (uint32_t)sync->elapsed_us);
+    payload[12] = sync->hop;
+    payload[COORD_PAYLOAD_SIZE] = coord_crc8(payload, COORD_PAYLOAD_SIZE);
+    return COORD_FRAME_SIZE;
+}
+
+void coord_decoder_reset(coord_decoder_t *decoder)
+{
+    decoder->state = DECODE_SYNC;
+    decoder->index = 0;
+    decoder->length = 0;
+}
+
+// Consome um byte do enlace; retorna true quando um quadro válido termina.
+bool coord_decode_byte(coord_decoder_t *decoder, uint8_t byte, coord_sync_t *sync)
+{
+    switch (decoder->state)
+    {
+    case DECODE_SYNC:
+        if (byte == COORD_FRAME_SYNC)
+            decoder->state = DECODE_CHANNEL;
+        break;
+
+    case DECODE_CHANNEL:
+        decoder->state = byte == COORD_FRAME_CHANNEL ? DECODE_LENGTH : DECODE_SYNC;
+        break;
+
+    case DECODE_LENGTH:
+        decoder->length = byte;
+        decoder->index = 0;
+        decoder->state = byte == COORD_PAYLOAD_SIZE ? DECODE_PAYLOAD : DECODE_SYNC;
+        break;
+
+    case DECODE_PAYLOAD:
+        decoder->payload[decoder->index++] = byte;
+        if (decoder->index == decoder->length)
+            decoder->state = DECODE_CRC;
+        break;
+
+    case DECODE_CRC:
+        decoder->state = DECODE_SYNC;
+        if (byte != coord_crc8(decoder->payload, decoder->length))
+            return false;
+
+        sync->cycle = get_u32(&decoder->payload[0]);
+        sync->cycle_length_us = get_u32(&decoder->payload[4]);
+        sync->elapsed_us = (int32_t)get_u32(&decoder->payload[8]);
+        sync->hop = decoder->payload[12];
+        return true;
+    }
+    return false;
+}
+
+static int32_t clamp32(int64_t value, int32_t limit)
+{
+    if (value > limit)
+        return limit;
+    if (value < -limit)
+        return -limit;
+    return (int32_t)value;
+}
+
+// Inicia o motor de fase; o primeiro ciclo começa um ciclo nominal após now_us.
+void coord_engine_init(coord_engine_t *engine, const coord_config_t *config, bool is_leader, uint64_t now_us)
+{
+    *engine = (coord_engine_t){
+        .config = *config,
+        .is_leader = is_leader,
+        .cycle_start_us = now_us,
+        .next_start_us = now_us + config->cycle_length_us,
+    };
+}
+
+uint64_t coord_engine_next_start(const coord_engine_t *engine)
+{
+    return engine->next_start_us;
+}
+
+// Avança o próximo início em cycles ciclos (com a correção de deriva) e conta a falta de sincronismo.
+static void advance_cycles(coord_engine_t *engine, uint32_t cycles)
+{
+    engine->cycle += cycles;
+    engine->next_start_us += (uint64_t)cycles * (engine->config.cycle_length_us - engine->stats.trim_us);
+
+    if (engine->is_leader || !engine->is_locked)
+        return;
+
+    // Sem sincronismo por muito tempo o seguidor segue livre, com a última correção de deriva.
+    uint32_t since_sync = engine->cycles_since_sync + cycles;
+    engine->cycles_since_sync = since_sync > UINT8_MAX ? UINT8_MAX : since_sync;
+    if (engine->cycles_since_sync > engine->config.holdover_cycles)
+    {
+        engine->is_locked = false;
+        engine->stats.lost++;
+    }
+}
+
+// Marca o início do ciclo programado e programa o seguinte.
+void coord_engine_advance(coord_engine_t *engine)
+{
+    engine->cycle_start_us = engine->next_start_us;
+    advance_cycles(engine, 1);
+}
+
+// Descarta os inícios anteriores a earliest_us (ciclos não executados, ex.: durante o modo
+// noturno), em ciclos inteiros: o próximo início continua na mesma grade de fase. Retorna o
+// número de ciclos descartados.
+uint32_t coord_engine_skip_missed(coord_engine_t *engine, uint64_t earliest_us)
+{
+    if (engine->next_start_us >= earliest_us)
+        return 0;
+
+    uint64_t period = engine->config.cycle_length_us - engine->stats.trim_us;
+    uint32_t missed = (earliest_us - engine->next_start_us + period - 1) / period;
+    advance_cycles(engine, missed);
+    return missed;
+}
+
+// O líder sempre transmite; um seguidor só repassa o sincronismo enquanto estiver travado.
+bool coord_engine_should_emit(const coord_engine_t *engine)
+{
+    return engine->is_leader || engine->is_locked;
+}
+
+void coord_engine_make_sync(const coord_engine_t *engine, uint64_t now_us, coord_sync_t *sync)
+{
+    *sync = (coord_sync_t){
+        .cycle = engine->cycle,
+        .cycle_length_us = engine->config.cycle_length_us,
+        .elapsed_us = (int32_t)(now_us - engine->cycle_start_us),
+        .hop = engine->is_leader ? 0 : engine->hop,
+    };
+}
+
+// Compara o próximo início local com o instante alvo (início a montante + defasagem) e corrige a fase.
+void coord_engine_on_sync(coord_engine_t *engine, const coord_sync_t *sync, uint64_t rx_us)
+{
+    const coord_config_t *config = &engine->config;
+    if (engine->is_leader)
+        return;
+
+    // A defasagem é medida no relógio local: a correção de deriva (trim) a converte para o ritmo
+    // do vizinho a montante, assim como faz com a duração do ciclo.
+    int64_t cycle = config->cycle_length_us;
+    int64_t offset = (int64_t)config->offset_us * (cycle - engine->stats.trim_us) / cycle;
+    uint64_t upstream_start = rx_us - config->link_delay_us - (int64_t)sync->elapsed_us;
+    uint64_t target = upstream_start + offset;
+
+    // Erro de fase no intervalo [-ciclo/2, ciclo/2): positivo quando o ciclo local está atrasado.
+    int64_t error = (int64_t)(engine->next_start_us - target) % cycle;
+    if (error >= cycle / 2)
+        error -= cycle;
+    else if (error < -cycle / 2)
+        error += cycle;
+
+    engine->hop = sync->hop + 1;
+    engine->cycles_since_sync = 0;
+    engine->stats.syncs++;
+    engine->stats.last_error_us = (int32_t)error;
+
+    if (!engine->is_locked || error > config->step_threshold_us || -error > config->step_threshold_us)
+    {
+        // Fora da faixa do servo: salta para a fase alvo e recomeça o integrador.
+        engine->next_start_us -= error;
+        if ((int64_t)(engine->next_start_us - rx_us) <= 0)
+            engine->next_start_us += cycle;
+        engine->integral_us = 0;
+        engine->stats.trim_us = 0;
+        engine->stats.steps++;
+        engine->is_locked = true;
+        return;
+    }
+
+    uint32_t abs_error = error < 0 ? -error : error;
+    engine->stats.locked_syncs++;
+    engine->stats.sum_abs_error_us += abs_error;
+    if (abs_error > engine->stats.max_abs_error_us)
+        engine->stats.max_abs_error_us = abs_error;
+
+    // Proporcional corrige a fase do próximo ciclo; integral ajusta a duração do ciclo (deriva).
+    engine->next_start_us -= clamp32(error * config->kp_q8 / 256, config->max_slew_us);
+    engine->integral_us = clamp32((int64_t)engine->integral_us + error, INT32_MAX / 256);
+    engine->stats.trim_us = clamp32((int64_t)engine->integral_us * config->ki_q8 / 256, config->max_slew_us);
+}
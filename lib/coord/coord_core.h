@@ -0,0 +1,83 @@
+#ifndef COORD_CORE_H
+#define COORD_CORE_H
+
+// Núcleo portátil da coordenação em onda verde: codificação dos quadros de sincronismo e
+// servo de fase dos seguidores. Não depende do SDK do Pico; tools/coord_sim.c o usa no Linux.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define COORD_FRAME_SYNC 0xA5      // Mesmo sincronismo dos quadros do log binário
+#define COORD_FRAME_CHANNEL 0x02   // Canal dos quadros de sincronismo de ciclo
+#define COORD_PAYLOAD_SIZE 13      // ciclo u32, duração u32, decorrido i32, salto u8
+#define COORD_FRAME_SIZE (3 + COORD_PAYLOAD_SIZE + 1)
+
+// Quadro de início de ciclo enviado pelo líder e reenviado por cada seguidor travado.
+typedef struct coord_sync_t
+{
+    uint32_t cycle;           // Número do ciclo do remetente
+    uint32_t cycle_length_us; // Duração nominal do ciclo
+    int32_t elapsed_us;       // Início do envio em relação ao início do ciclo do remetente
+    uint8_t hop;              // 0 no líder, +1 a cada reenvio
+} coord_sync_t;
+
+typedef struct coord_config_t
+{
+    uint32_t cycle_length_us; // Duração nominal do ciclo
+    int32_t offset_us;        // Início do ciclo local em relação ao do vizinho a montante
+    uint32_t link_delay_us;   // Tempo de transmissão do quadro + latência fixa do enlace
+    uint16_t kp_q8;           // Ganho proporcional (Q8) aplicado à fase do próximo ciclo
+    uint16_t ki_q8;           // Ganho integral (Q8) que corrige a deriva do oscilador
+    uint32_t step_threshold_us; // Erro acima do qual a fase é ajustada em um salto
+    uint32_t max_slew_us;     // Correção máxima de fase por ciclo
+    uint8_t holdover_cycles;  // Ciclos sem sincronismo antes de perder a trava
+} coord_config_t;
+
+typedef struct coord_stats_t
+{
+    uint32_t syncs;            // Quadros de sincronismo recebidos
+    uint32_t steps;            // Ajustes de fase em salto
+    uint32_t lost;             // Perdas de trava por falta de sincronismo
+    int32_t last_error_us;     // Erro de fase medido no último quadro
+    uint32_t max_abs_error_us; // Maior erro com a fase travada (sem contar saltos)
+    uint64_t sum_abs_error_us; // Soma dos erros travados (para a média)
+    uint32_t locked_syncs;     // Quadros recebidos com a fase travada
+    int32_t trim_us;           // Correção de duração do ciclo (deriva do oscilador)
+} coord_stats_t;
+
+typedef struct coord_engine_t
+{
+    coord_config_t config;
+    bool is_leader;
+    bool is_locked;
+    uint8_t hop;                 // Distância ao líder
+    uint32_t cycle;              // Ciclos iniciados
+    uint64_t cycle_start_us;     // Início do ciclo atual (relógio local)
+    uint64_t next_start_us;      // Início programado do próximo ciclo
+    int32_t integral_us;         // Acumulador do termo integral
+    uint8_t cycles_since_sync;
+    coord_stats_t stats;
+} coord_engine_t;
+
+typedef struct coord_decoder_t
+{
+    uint8_t state;
+    uint8_t index;
+    uint8_t length;
+    uint8_t payload[COORD_PAYLOAD_SIZE];
+} coord_decoder_t;
+
+uint8_t coord_crc8(const uint8_t *data, uint8_t length);
+uint8_t coord_encode(const coord_sync_t *sync, uint8_t frame[COORD_FRAME_SIZE]);
+void coord_decoder_reset(coord_decoder_t *decoder);
+bool coord_decode_byte(coord_decoder_t *decoder, uint8_t byte, coord_sync_t *sync);
+
+void coord_engine_init(coord_engine_t *engine, const coord_config_t *config, bool is_leader, uint64_t now_us);
+uint64_t coord_engine_next_start(const coord_engine_t *engine);
+void coord_engine_advance(coord_engine_t *engine);
+uint32_t coord_engine_skip_missed(coord_engine_t *engine, uint64_t earliest_us);
+bool coord_engine_should_emit(const coord_engine_t *engine);
+void coord_engine_make_sync(const coord_engine_t *engine, uint64_t now_us, coord_sync_t *sync);
+void coord_engine_on_sync(coord_engine_t *engine, const coord_sync_t *sync, uint64_t rx_us);
+
+#endif // COORD_CORE_H
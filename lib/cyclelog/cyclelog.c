@@ -0,0 +1,513 @@
+#include <string.h>
+#include "cyclelog.h"
+#include "hardware/structs/timer.h"
+#include "hardware/sync.h"
+#include "log/log.h"
+#include "timebase/timebase.h"
+
+extern char __flash_binary_end; // Fim do programa na flash (definido pelo linker script)
+
+// Comandos da flash (W25Q16JV) usados no apagamento em fatias
+#define FLASH_CMD_WRITE_ENABLE 0x06
+#define FLASH_CMD_READ_STATUS1 0x05
+#define FLASH_CMD_READ_STATUS2 0x35
+#define FLASH_CMD_SECTOR_ERASE 0x20
+#define FLASH_CMD_ERASE_SUSPEND 0x75
+#define FLASH_CMD_ERASE_RESUME 0x7A
+#define FLASH_STATUS1_BUSY 0x01
+#define FLASH_STATUS2_SUSPENDED 0x80
+
+// O bloqueio declarado no plano de tarefas precisa cobrir uma fatia de apagamento
+_Static_assert(CYCLELOG_ERASE_SLICE_US + CYCLELOG_ERASE_SUSPEND_US < CYCLELOG_BLOCKING_US,
+               "fatia de apagamento maior que o bloqueio declarado do registro de ciclos");
+
+// Página selada aguardando gravação.
+typedef struct queued_page_t
+{
+    uint32_t sequence;
+    uint16_t used;
+    uint8_t count;
+    uint8_t data[CYCLELOG_PAGE_SIZE];
+} queued_page_t;
+
+typedef struct cyclelog_stats_t
+{
+    uint32_t cycles;          // Ciclos registrados desde o boot
+    uint32_t pages;           // Páginas gravadas
+    uint32_t records;         // Ciclos nas páginas gravadas
+    uint32_t bytes;           // Bytes ocupados nas páginas gravadas
+    uint32_t erases;          // Setores apagados
+    uint32_t erase_slices;    // Fatias de apagamento executadas
+    uint32_t dropped;         // Páginas descartadas com a fila cheia
+    uint32_t max_program_us;
+    uint32_t max_erase_us;    // Maior fatia de apagamento (interrupções desligadas)
+    uint64_t flash_us;        // Tempo total com as interrupções desligadas na flash
+} cyclelog_stats_t;
+
+static bool enabled = false;
+static uint16_t boot_id = 0;
+
+// A página de sequência s ocupa sempre a posição s % CYCLELOG_PAGES da região: o boot retoma a
+// sequência a partir da página mais nova e a leitura localiza qualquer página sem índice.
+static uint32_t next_sequence = 0;    // Sequência da próxima página aberta
+static uint32_t erased_limit = 0;     // Primeira sequência cuja posição ainda não foi apagada
+static bool erase_is_suspended = false; // Setor em erased_limit com apagamento iniciado e suspenso
+
+static cyclelog_page_t page;          // Página em preenchimento na RAM
+static uint32_t page_sequence;
+static bool page_is_open = false;
+static uint32_t page_opened_ms;
+static cyclelog_base_t last_base;     // Referência das diferenças entre páginas
+
+static queued_page_t queue[CYCLELOG_QUEUE_PAGES];
+static uint8_t queue_head = 0;
+static uint8_t queue_count = 0;
+
+// Ciclo em montagem
+static bool cycle_is_open = false;
+static cyclelog_record_t cycle;
+static cyclelog_counters_t cycle_totals; // Contadores no início do ciclo
+static uint8_t phase_state;
+static uint32_t phase_start_ms;
+
+// Leitura em andamento
+static bool stream_active = false;
+static uint16_t stream_boot;
+static uint32_t stream_from_ms;
+static uint32_t stream_to_ms;
+static uint32_t stream_sequence;      // Próxima sequência a examinar
+static uint32_t stream_pages;         // Páginas enviadas
+static cyclelog_page_t stream_copy;   // Fora da pilha da tarefa do log
+static uint8_t stream_data[CYCLELOG_PAGE_SIZE];
+
+static cyclelog_stats_t stats;
+
+static const uint8_t *flash_page(uint32_t sequence)
+{
+    return (const uint8_t *)(XIP_BASE + CYCLELOG_REGION_OFFSET + (sequence % CYCLELOG_PAGES) * FLASH_PAGE_SIZE);
+}
+
+static bool is_blank(const uint8_t *data)
+{
+    for (uint16_t i = 0; i < CYCLELOG_PAGE_SIZE; i++)
+    {
+        if (data[i] != 0xFF)
+            return false;
+    }
+    return true;
+}
+
+// Localiza a página mais nova: o boot seguinte recebe um novo identificador e a escrita continua
+// na posição seguinte. Uma posição suja no resto do setor (gravação interrompida) faz a escrita
+// pular para o próximo setor, que será apagado antes do uso.
+static void scan_region()
+{
+    bool found = false;
+    uint32_t newest = 0;
+    uint16_t newest_boot = 0;
+    for (uint32_t position = 0; position < CYCLELOG_PAGES; position++)
+    {
+        cyclelog_page_info_t info;
+        if (!cyclelog_page_parse(flash_page(position), &info) || info.sequence % CYCLELOG_PAGES != position)
+            continue;
+
+        if (!found || info.sequence > newest)
+        {
+            newest = info.sequence;
+            newest_boot = info.boot;
+        }
+        found = true;
+    }
+
+    boot_id = found ? newest_boot + 1 : 0;
+    next_sequence = found ? newest + 1 : 0;
+
+    uint32_t sector_end = (next_sequence / CYCLELOG_PAGES_PER_SECTOR + 1) * CYCLELOG_PAGES_PER_SECTOR;
+    bool blank = true;
+    for (uint32_t sequence = next_sequence; sequence < sector_end && blank; sequence++)
+        blank = is_blank(flash_page(sequence));
+
+    if (blank)
+        erased_limit = sector_end;
+    else
+    {
+        if (next_sequence % CYCLELOG_PAGES_PER_SECTOR)
+            next_sequence = sector_end;
+        erased_limit = next_sequence;
+    }
+}
+
+// Lê um registrador de estado da flash. Executa da RAM: pode ser chamada com a flash apagando.
+static uint8_t __no_inline_not_in_flash_func(flash_read_status)(uint8_t command)
+{
+    uint8_t tx[2] = {command, 0}, rx[2];
+    flash_do_cmd(tx, rx, sizeof(tx));
+    return rx[1];
+}
+
+// Inicia (start) ou retoma o apagamento do setor em offset e o deixa correr por até
+// CYCLELOG_ERASE_SLICE_US; se não terminar, o suspende. Enquanto apaga, a flash só atende leituras
+// de estado: a função executa da RAM e deve ser chamada com as interrupções desligadas. Após a
+// suspensão a flash volta a ser lida normalmente. Retorna true quando o setor está apagado.
+static bool __no_inline_not_in_flash_func(erase_slice)(uint32_t offset, bool start)
+{
+    uint8_t rx[4];
+    if (start)
+    {
+        uint8_t enable = FLASH_CMD_WRITE_ENABLE;
+        uint8_t erase[4] = {FLASH_CMD_SECTOR_ERASE, offset >> 16, offset >> 8, offset};
+        flash_do_cmd(&enable, rx, 1);
+        flash_do_cmd(erase, rx, sizeof(erase));
+    }
+    else
+    {
+        uint8_t resume = FLASH_CMD_ERASE_RESUME;
+        flash_do_cmd(&resume, rx, 1);
+    }
+
+    uint32_t begin_us = timer_hw->timerawl;
+    while (timer_hw->timerawl - begin_us < CYCLELOG_ERASE_SLICE_US)
+    {
+        if (!(flash_read_status(FLASH_CMD_READ_STATUS1) & FLASH_STATUS1_BUSY))
+            return true;
+    }
+
+    // A suspensão leva até 20 us. Se o apagamento terminar nesse meio-tempo, a próxima chamada
+    // encontra a flash livre e o conclui.
+    uint8_t suspend = FLASH_CMD_ERASE_SUSPEND;
+    flash_do_cmd(&suspend, rx, 1);
+    while (flash_read_status(FLASH_CMD_READ_STATUS1) & FLASH_STATUS1_BUSY)
+        ;
+    return false;
+}
+
+// Um reinício (watchdog) pode deixar um apagamento suspenso, e a flash recusa um novo apagamento
+// até concluí-lo. Chamada no boot, antes do escalonador: a espera não atrasa nenhuma tarefa.
+static void __no_inline_not_in_flash_func(finish_suspended_erase)()
+{
+    if (!(flash_read_status(FLASH_CMD_READ_STATUS2) & FLASH_STATUS2_SUSPENDED))
+        return;
+
+    uint8_t resume = FLASH_CMD_ERASE_RESUME, rx;
+    flash_do_cmd(&resume, &rx, 1);
+    while (flash_read_status(FLASH_CMD_READ_STATUS1) & FLASH_STATUS1_BUSY)
+        ;
+}
+
+// Verifica que a região não se sobrepõe ao programa e retoma a sequência gravada.
+void cyclelog_init()
+{
+    if ((uintptr_t)&__flash_binary_end - XIP_BASE > CYCLELOG_REGION_OFFSET)
+    {
+        LOG0(LOG_CYCLELOG_DISABLED);
+        return;
+    }
+
+    uint32_t irq_state = save_and_disable_interrupts();
+    finish_suspended_erase();
+    restore_interrupts(irq_state);
+    scan_region();
+    enabled = true;
+}
+
+uint16_t cyclelog_boot()
+{
+    return boot_id;
+}
+
+// Sela a página em preenchimento e a coloca na fila de gravação (chamada com interrupções desligadas).
+static void close_page()
+{
+    cyclelog_page_seal(&page, boot_id, page_sequence);
+    page_is_open = false;
+    last_base = page.base;
+
+    if (queue_count == CYCLELOG_QUEUE_PAGES)
+    {
+        stats.dropped++;
+        LOG1(LOG_CYCLELOG_DROPPED, page_sequence);
+        return;
+    }
+
+    queued_page_t *entry = &queue[(queue_head + queue_count) % CYCLELOG_QUEUE_PAGES];
+    entry->sequence = page_sequence;
+    entry->used = page.used;
+    entry->count = page.count;
+    memcpy(entry->data, page.data, CYCLELOG_PAGE_SIZE);
+    queue_count++;
+}
+
+// Codifica uma entrada na página em preenchimento (chamada com interrupções desligadas).
+static void append_record(const cyclelog_record_t *record)
+{
+    for (uint8_t attempt = 0; attempt < 2; attempt++)
+    {
+        if (!page_is_open)
+        {
+            cyclelog_page_open(&page, &last_base);
+            page_sequence = next_sequence++;
+            page_opened_ms = record->start_ms;
+            page_is_open = true;
+        }
+        if (cyclelog_page_append(&page, record))
+        {
+            stats.cycles++;
+            break;
+        }
+        close_page(); // Página cheia: a entrada vai para a próxima
+    }
+}
+
+// Chamada a cada fase agendada. Um ciclo começa no verde e termina no próximo verde; uma troca de
+// modo também o encerra, para que cada entrada tenha um único conjunto de modos.
+void cyclelog_on_phase(uint32_t boundary_ms, uint8_t light_state, uint8_t flags,
+                       const cyclelog_counters_t *totals)
+{
+    if (!enabled)
+        return;
+
+    // O controle e o monitor de prazos (modo de segurança) publicam fases
+    uint32_t irq_state = save_and_disable_interrupts();
+    if (cycle_is_open)
+    {
+        cycle.phase_ms[phase_state] += boundary_ms - phase_start_ms;
+        bool closes = (light_state == 0 && phase_state != 0) || flags != cycle.flags;
+        if (!closes)
+        {
+            phase_state = light_state;
+            phase_start_ms = boundary_ms;
+            restore_interrupts(irq_state);
+            return;
+        }
+
+        cycle.misses = totals->misses - cycle_totals.misses;
+        cycle.pedestrian_calls = totals->pedestrian_calls - cycle_totals.pedestrian_calls;
+        cycle.vehicles = totals->vehicles - cycle_totals.vehicles;
+        append_record(&cycle);
+    }
+    else
+    {
+        last_base = (cyclelog_base_t){.start_ms = boundary_ms}; // Primeira entrada do boot
+    }
+
+    cycle = (cyclelog_record_t){.start_ms = boundary_ms, .flags = flags};
+    cycle_totals = *totals;
+    cycle_is_open = true;
+    phase_state = light_state;
+    phase_start_ms = boundary_ms;
+    restore_interrupts(irq_state);
+}
+
+// Operações na flash só logo após uma fronteira de fase e longe da próxima: com as interrupções
+// desligadas, nenhum alarme do relógio de fase pode ser atrasado.
+static bool in_slack(uint32_t guard_us)
+{
+    timebase_phase_t phase;
+    timebase_get_current(&phase);
+    uint64_t now_us = time_us_64();
+    if (phase.boundary_us == 0 || now_us - phase.boundary_us > CYCLELOG_SLACK_WINDOW_US)
+        return false;
+
+    uint64_t next_us;
+    return !timebase_get_pending_boundary(&next_us) || next_us > now_us + guard_us;
+}
+
+static void record_flash_time(uint32_t elapsed_us, uint32_t *max_us)
+{
+    stats.flash_us += elapsed_us;
+    if (elapsed_us > *max_us)
+        *max_us = elapsed_us;
+}
+
+// Apaga o próximo setor quando restam poucas posições livres (descarta as páginas mais antigas).
+// O apagamento avança uma fatia por chamada, com as interrupções desligadas por no máximo
+// CYCLELOG_ERASE_SLICE_US mais a suspensão, em vez do setor inteiro (até ~400 ms). Retorna true
+// enquanto houver um apagamento em curso: nada é gravado com a flash suspensa.
+static bool erase_ahead(uint32_t program_sequence)
+{
+    if (!erase_is_suspended && (int32_t)(erased_limit - program_sequence) > CYCLELOG_PAGES_PER_SECTOR / 4)
+        return false;
+    if (!in_slack(CYCLELOG_ERASE_GUARD_US))
+        return erase_is_suspended;
+
+    uint32_t offset = CYCLELOG_REGION_OFFSET + (erased_limit % CYCLELOG_PAGES) * FLASH_PAGE_SIZE;
+    uint64_t begin_us = time_us_64();
+    uint32_t irq_state = save_and_disable_interrupts();
+    bool is_done = erase_slice(offset, !erase_is_suspended);
+    restore_interrupts(irq_state);
+    record_flash_time((uint32_t)(time_us_64() - begin_us), &stats.max_erase_us);
+    stats.erase_slices++;
+
+    erase_is_suspended = !is_done;
+    if (is_done)
+    {
+        erased_limit += CYCLELOG_PAGES_PER_SECTOR;
+        stats.erases++;
+    }
+    return true;
+}
+
+// Grava a página mais antiga da fila.
+static void program_head()
+{
+    queued_page_t *entry = &queue[queue_head];
+    if (entry->sequence >= erased_limit || !in_slack(CYCLELOG_PROGRAM_GUARD_US))
+        return;
+
+    uint32_t offset = CYCLELOG_REGION_OFFSET + (entry->sequence % CYCLELOG_PAGES) * FLASH_PAGE_SIZE;
+    uint64_t begin_us = time_us_64();
+    uint32_t irq_state = save_and_disable_interrupts();
+    flash_range_program(offset, entry->data, FLASH_PAGE_SIZE);
+    restore_interrupts(irq_state);
+    record_flash_time((uint32_t)(time_us_64() - begin_us), &stats.max_program_us);
+
+    irq_state = save_and_disable_interrupts();
+    stats.pages++;
+    stats.records += entry->count;
+    stats.bytes += entry->used;
+    queue_head = (queue_head + 1) % CYCLELOG_QUEUE_PAGES;
+    queue_count--;
+    restore_interrupts(irq_state);
+}
+
+// Chamada periodicamente por uma tarefa de baixa prioridade: fecha a página parcial antiga,
+// apaga o setor seguinte com antecedência e grava a fila, uma operação por chamada.
+void cyclelog_service()
+{
+    if (!enabled)
+        return;
+
+    uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+    uint32_t irq_state = save_and_disable_interrupts();
+    if (page_is_open && page.count && now_ms - page_opened_ms >= CYCLELOG_FLUSH_MS)
+        close_page();
+    uint32_t program_sequence = queue_count ? queue[queue_head].sequence : next_sequence;
+    restore_interrupts(irq_state);
+
+    if (erase_ahead(program_sequence))
+        return;
+    if (queue_count)
+        program_head();
+}
+
+// Inicia o envio das páginas de um boot (ou de todos) com ciclos no intervalo dado.
+bool cyclelog_stream_begin(uint16_t boot, uint32_t from_ms, uint32_t to_ms)
+{
+    if (!enabled)
+        return false;
+
+    stream_boot = boot;
+    stream_from_ms = from_ms;
+    stream_to_ms = to_ms;
+    stream_sequence = next_sequence > CYCLELOG_PAGES ? next_sequence - CYCLELOG_PAGES : 0;
+    stream_pages = 0;
+    stream_active = true;
+    return true;
+}
+
+// Copia a página de uma sequência, esteja ela na fila, em preenchimento ou na flash.
+static void read_page(uint32_t sequence, uint8_t data[CYCLELOG_PAGE_SIZE])
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+    for (uint8_t i = 0; i < queue_count; i++)
+    {
+        queued_page_t *entry = &queue[(queue_head + i) % CYCLELOG_QUEUE_PAGES];
+        if (entry->sequence == sequence)
+        {
+            memcpy(data, entry->data, CYCLELOG_PAGE_SIZE);
+            restore_interrupts(irq_state);
+            return;
+        }
+    }
+    if (page_is_open && page.count && page_sequence == sequence)
+    {
+        stream_copy = page; // A página em RAM é enviada selada, sem interromper o preenchimento
+        restore_interrupts(irq_state);
+        cyclelog_page_seal(&stream_copy, boot_id, sequence);
+        memcpy(data, stream_copy.data, CYCLELOG_PAGE_SIZE);
+        return;
+    }
+    restore_interrupts(irq_state);
+    memcpy(data, flash_page(sequence), CYCLELOG_PAGE_SIZE);
+}
+
+static void send_page(uint32_t sequence, const uint8_t data[CYCLELOG_PAGE_SIZE])
+{
+    // Cada quadro leva meia página: [sequência u32][parte u8][128 bytes]
+    uint8_t payload[5 + CYCLELOG_PAGE_SIZE / 2];
+    memcpy(payload, &sequence, sizeof(sequence));
+    for (uint8_t part = 0; part < 2; part++)
+    {
+        payload[4] = part;
+        memcpy(&payload[5], &data[part * CYCLELOG_PAGE_SIZE / 2], CYCLELOG_PAGE_SIZE / 2);
+        log_send_frame(CYCLELOG_FRAME_CHANNEL, payload, sizeof(payload));
+    }
+}
+
+// Avança a leitura em ordem de sequência (a mais antiga primeiro); chamada pela tarefa do log.
+// Retorna false quando não há leitura em andamento.
+bool cyclelog_stream_step()
+{
+    if (!stream_active)
+        return false;
+
+    uint8_t sent = 0;
+    for (uint8_t scanned = 0; scanned < CYCLELOG_STREAM_SCAN && sent < CYCLELOG_STREAM_PAGES; scanned++)
+    {
+        if (stream_sequence >= next_sequence) // A página em preenchimento é a última
+        {
+            // Quadro final: [0xFFFFFFFF][0xFF][páginas enviadas u32]
+            uint8_t payload[9] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+            memcpy(&payload[5], &stream_pages, sizeof(stream_pages));
+            log_send_frame(CYCLELOG_FRAME_CHANNEL, payload, sizeof(payload));
+            stream_active = false;
+            return false;
+        }
+
+        uint32_t sequence = stream_sequence++;
+        cyclelog_page_info_t info;
+        read_page(sequence, stream_data);
+        if (!cyclelog_page_parse(stream_data, &info) || info.sequence != sequence)
+            continue; // Posição apagada, descartada ou sobrescrita
+
+        if ((stream_boot != CYCLELOG_ANY_BOOT && info.boot != stream_boot) || info.last_ms < stream_from_ms ||
+            info.first_ms > stream_to_ms)
+            continue;
+
+        send_page(sequence, stream_data);
+        stream_pages++;
+        sent++;
+    }
+    return true;
+}
+
+// Imprime o volume gravado, o custo por ciclo e o tempo máximo com as interrupções desligadas.
+void cyclelog_report()
+{
+    if (!enabled)
+    {
+        printf("registro;desabilitado\n");
+        return;
+    }
+
+    uint32_t irq_state = save_and_disable_interrupts();
+    cyclelog_stats_t totals = stats;
+    uint8_t queued = queue_count;
+    uint32_t sequence = next_sequence;
+    restore_interrupts(irq_state);
+
+    // Em décimos: bytes codificados e bytes de flash consumidos por ciclo, e custo de gravação
+    uint32_t bytes = totals.records ? totals.bytes * 10 / totals.records : 0;
+    uint32_t flash = totals.records ? totals.pages * CYCLELOG_PAGE_SIZE * 10 / totals.records : 0;
+    uint32_t cost_us = totals.records ? (uint32_t)(totals.flash_us / totals.records) : 0;
+    printf("registro;boot;%u;ciclos;%lu;paginas;%lu;setores_apagados;%lu;fatias_de_apagamento;%lu;fila;%u;"
+           "descartadas;%lu;posicao;%lu\n",
+           boot_id, (unsigned long)totals.cycles, (unsigned long)totals.pages, (unsigned long)totals.erases,
+           (unsigned long)totals.erase_slices, queued, (unsigned long)totals.dropped,
+           (unsigned long)(sequence % CYCLELOG_PAGES));
+    printf("bytes_por_ciclo;%lu.%lu;flash_por_ciclo;%lu.%lu;gravacao_max_us;%lu;apagamento_max_us;%lu;"
+           "custo_por_ciclo_us;%lu\n",
+           (unsigned long)(bytes / 10), (unsigned long)(bytes % 10), (unsigned long)(flash / 10),
+           (unsigned long)(flash % 10), (unsigned long)totals.max_program_us, (unsigned long)totals.max_erase_us,
+           (unsigned long)cost_us);
+}
@@ -0,0 +1,46 @@
+#ifndef CYCLELOG_H
+#define CYCLELOG_H
+
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+#include "cyclelog_codec.h"
+
+#define CYCLELOG_SECTORS 64                   // Região circular no fim da flash (256 KiB)
+#define CYCLELOG_PAGES_PER_SECTOR (FLASH_SECTOR_SIZE / FLASH_PAGE_SIZE)
+#define CYCLELOG_PAGES (CYCLELOG_SECTORS * CYCLELOG_PAGES_PER_SECTOR)
+#define CYCLELOG_REGION_SIZE (CYCLELOG_SECTORS * FLASH_SECTOR_SIZE)
+#define CYCLELOG_REGION_OFFSET (PICO_FLASH_SIZE_BYTES - CYCLELOG_REGION_SIZE)
+#define CYCLELOG_QUEUE_PAGES 2                // Páginas completas aguardando uma folga para gravação
+#define CYCLELOG_FLUSH_MS 600000              // Uma página parcial é gravada após 10 min
+#define CYCLELOG_SERVICE_MS 100               // Período da tarefa que grava e apaga
+#define CYCLELOG_SLACK_WINDOW_US 1000000      // Gravações só logo após uma fronteira de fase...
+#define CYCLELOG_ERASE_GUARD_US 10000         // ...e longe da próxima (uma fatia de apagamento leva ~1 ms)
+#define CYCLELOG_PROGRAM_GUARD_US 10000       // Programar uma página leva ~1 ms
+#define CYCLELOG_ERASE_SLICE_US 800           // Avanço do apagamento por chamada; o setor leva até ~400 ms
+#define CYCLELOG_ERASE_SUSPEND_US 20          // Suspensão do apagamento (máximo do datasheet)
+#define CYCLELOG_BLOCKING_US 3000             // Maior trecho com interrupções desligadas: programar uma página
+                                              // (máximo do datasheet) ou uma fatia de apagamento mais a suspensão
+#define CYCLELOG_FRAME_CHANNEL 0x03           // Canal da leitura do registro no fluxo USB
+#define CYCLELOG_STREAM_PAGES 4               // Páginas enviadas por chamada da leitura
+#define CYCLELOG_STREAM_SCAN 64               // Cabeçalhos examinados por chamada da leitura
+#define CYCLELOG_ANY_BOOT 0xFFFF
+
+// Contadores acumulados desde o boot; o registro guarda a diferença em cada ciclo.
+typedef struct cyclelog_counters_t
+{
+    uint32_t misses;
+    uint32_t pedestrian_calls;
+    uint32_t vehicles;
+} cyclelog_counters_t;
+
+void cyclelog_init();
+uint16_t cyclelog_boot();
+void cyclelog_on_phase(uint32_t boundary_ms, uint8_t light_state, uint8_t flags,
+                       const cyclelog_counters_t *totals);
+void cyclelog_service();
+bool cyclelog_stream_begin(uint16_t boot, uint32_t from_ms, uint32_t to_ms);
+bool cyclelog_stream_step();
+void cyclelog_report();
+
+#endif // CYCLELOG_H
@@ -0,0 +1,234 @@
+#include <string.h>
+#include "cyclelog_codec.h"
+
+// Posições no cabeçalho (little-endian)
+#define OFFSET_MAGIC 0
+#define OFFSET_BOOT 2
+#define OFFSET_SEQUENCE 4
+#define OFFSET_COUNT 8
+#define OFFSET_CRC 9
+#define OFFSET_USED 10
+#define OFFSET_BASE_START 12
+#define OFFSET_LAST_START 16
+#define OFFSET_BASE_INTERVAL 20
+#define OFFSET_BASE_PHASES 24
+#define OFFSET_BASE_FLAGS 36
+
+// CRC-8 (polinômio 0x07), o mesmo dos quadros do log binário; crc permite cálculo em partes.
+uint8_t cyclelog_crc8(uint8_t crc, const uint8_t *data, uint16_t length)
+{
+    for (uint16_t i = 0; i < length; i++)
+    {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++)
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+
+static void put_u16(uint8_t *buffer, uint16_t value)
+{
+    buffer[0] = value;
+    buffer[1] = value >> 8;
+}
+
+static void put_u32(uint8_t *buffer, uint32_t value)
+{
+    buffer[0] = value;
+    buffer[1] = value >> 8;
+    buffer[2] = value >> 16;
+    buffer[3] = value >> 24;
+}
+
+static uint16_t get_u16(const uint8_t *buffer)
+{
+    return buffer[0] | buffer[1] << 8;
+}
+
+static uint32_t get_u32(const uint8_t *buffer)
+{
+    return buffer[0] | buffer[1] << 8 | buffer[2] << 16 | (uint32_t)buffer[3] << 24;
+}
+
+static uint32_t zigzag(int32_t value)
+{
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int32_t unzigzag(uint32_t value)
+{
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+static uint8_t put_varint(uint8_t *buffer, uint32_t value)
+{
+    uint8_t length = 0;
+    while (value >= 0x80)
+    {
+        buffer[length++] = (uint8_t)value | 0x80;
+        value >>= 7;
+    }
+    buffer[length++] = (uint8_t)value;
+    return length;
+}
+
+// Lê um varint sem ultrapassar end; retorna NULL se truncado.
+static const uint8_t *get_varint(const uint8_t *buffer, const uint8_t *end, uint32_t *value)
+{
+    *value = 0;
+    for (uint8_t shift = 0; shift < 35 && buffer < end; shift += 7)
+    {
+        uint8_t byte = *buffer++;
+        *value |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return buffer;
+    }
+    return NULL;
+}
+
+// Inicia uma página vazia com o estado de referência da entrada anterior.
+void cyclelog_page_open(cyclelog_page_t *page, const cyclelog_base_t *base)
+{
+    memset(page->data, 0xFF, sizeof(page->data)); // Bytes não usados ficam como na flash apagada
+    page->used = CYCLELOG_HEADER_SIZE;
+    page->count = 0;
+    page->base = *base;
+
+    put_u32(&page->data[OFFSET_BASE_START], base->start_ms);
+    put_u32(&page->data[OFFSET_BASE_INTERVAL], base->interval_ms);
+    for (uint8_t i = 0; i < 3; i++)
+        put_u32(&page->data[OFFSET_BASE_PHASES + 4 * i], base->phase_ms[i]);
+    page->data[OFFSET_BASE_FLAGS] = base->flags;
+}
+
+// Codifica uma entrada; retorna false se ela não cabe (a página deve ser selada e outra aberta).
+bool cyclelog_page_append(cyclelog_page_t *page, const cyclelog_record_t *record)
+{
+    if (page->count == UINT8_MAX)
+        return false;
+
+    uint32_t interval_ms = record->start_ms - page->base.start_ms;
+    uint32_t fields[CYCLELOG_FIELD_COUNT] = {
+        zigzag((int32_t)(interval_ms - page->base.interval_ms)),
+        zigzag((int32_t)(record->phase_ms[0] - page->base.phase_ms[0])),
+        zigzag((int32_t)(record->phase_ms[1] - page->base.phase_ms[1])),
+        zigzag((int32_t)(record->phase_ms[2] - page->base.phase_ms[2])),
+        (uint32_t)(record->flags ^ page->base.flags),
+        record->misses,
+        record->pedestrian_calls,
+        record->vehicles,
+    };
+
+    uint8_t encoded[CYCLELOG_RECORD_MAX_SIZE];
+    uint8_t length = 1;
+    uint8_t mask = 0;
+    for (uint8_t i = 0; i < CYCLELOG_FIELD_COUNT; i++)
+    {
+        if (fields[i] == 0)
+            continue;
+        mask |= 1u << i;
+        length += put_varint(&encoded[length], fields[i]);
+    }
+    encoded[0] = mask;
+
+    if (page->used + length > CYCLELOG_PAGE_SIZE)
+        return false;
+
+    memcpy(&page->data[page->used], encoded, length);
+    page->used += length;
+    page->count++;
+    page->base = (cyclelog_base_t){
+        .start_ms = record->start_ms,
+        .interval_ms = interval_ms,
+        .phase_ms = {record->phase_ms[0], record->phase_ms[1], record->phase_ms[2]},
+        .flags = record->flags,
+    };
+    put_u32(&page->data[OFFSET_LAST_START], record->start_ms);
+    return true;
+}
+
+// Completa o cabeçalho: identificação, tamanho e CRC de todos os bytes ocupados exceto o próprio CRC.
+void cyclelog_page_seal(cyclelog_page_t *page, uint16_t boot, uint32_t sequence)
+{
+    put_u16(&page->data[OFFSET_MAGIC], CYCLELOG_PAGE_MAGIC);
+    put_u16(&page->data[OFFSET_BOOT], boot);
+    put_u32(&page->data[OFFSET_SEQUENCE], sequence);
+    page->data[OFFSET_COUNT] = page->count;
+    put_u16(&page->data[OFFSET_USED], page->used);
+    if (page->count == 0)
+        put_u32(&page->data[OFFSET_LAST_START], page->base.start_ms);
+
+    uint8_t crc = cyclelog_crc8(0, page->data, OFFSET_CRC);
+    page->data[OFFSET_CRC] = cyclelog_crc8(crc, &page->data[OFFSET_USED], page->used - OFFSET_USED);
+}
+
+// Valida uma página gravada e lê seu cabeçalho.
+bool cyclelog_page_parse(const uint8_t data[CYCLELOG_PAGE_SIZE], cyclelog_page_info_t *info)
+{
+    uint16_t used = get_u16(&data[OFFSET_USED]);
+    if (get_u16(&data[OFFSET_MAGIC]) != CYCLELOG_PAGE_MAGIC || used < CYCLELOG_HEADER_SIZE ||
+        used > CYCLELOG_PAGE_SIZE)
+        return false;
+
+    uint8_t crc = cyclelog_crc8(0, data, OFFSET_CRC);
+    if (cyclelog_crc8(crc, &data[OFFSET_USED], used - OFFSET_USED) != data[OFFSET_CRC])
+        return false;
+
+    *info = (cyclelog_page_info_t){
+        .boot = get_u16(&data[OFFSET_BOOT]),
+        .sequence = get_u32(&data[OFFSET_SEQUENCE]),
+        .count = data[OFFSET_COUNT],
+        .used = used,
+        .first_ms = get_u32(&data[OFFSET_BASE_START]),
+        .last_ms = get_u32(&data[OFFSET_LAST_START]),
+    };
+    return true;
+}
+
+// Decodifica as entradas de uma página válida; retorna false se a codificação estiver corrompida.
+bool cyclelog_page_decode(const uint8_t data[CYCLELOG_PAGE_SIZE], cyclelog_record_t *records, uint8_t max_count)
+{
+    cyclelog_page_info_t info;
+    if (!cyclelog_page_parse(data, &info))
+        return false;
+
+    cyclelog_base_t base = {
+        .start_ms = get_u32(&data[OFFSET_BASE_START]),
+        .interval_ms = get_u32(&data[OFFSET_BASE_INTERVAL]),
+        .flags = data[OFFSET_BASE_FLAGS],
+    };
+    for (uint8_t i = 0; i < 3; i++)
+        base.phase_ms[i] = get_u32(&data[OFFSET_BASE_PHASES + 4 * i]);
+
+    const uint8_t *cursor = &data[CYCLELOG_HEADER_SIZE];
+    const uint8_t *end = &data[info.used];
+    for (uint8_t n = 0; n < info.count && n < max_count; n++)
+    {
+        if (cursor >= end)
+            return false;
+
+        uint8_t mask = *cursor++;
+        uint32_t fields[CYCLELOG_FIELD_COUNT] = {0};
+        for (uint8_t i = 0; i < CYCLELOG_FIELD_COUNT; i++)
+        {
+            if (mask & (1u << i) && !(cursor = get_varint(cursor, end, &fields[i])))
+                return false;
+        }
+
+        base.interval_ms += unzigzag(fields[0]);
+        base.start_ms += base.interval_ms;
+        for (uint8_t i = 0; i < 3; i++)
+            base.phase_ms[i] += unzigzag(fields[1 + i]);
+        base.flags ^= fields[4];
+
+        records[n] = (cyclelog_record_t){
+            .start_ms = base.start_ms,
+            .phase_ms = {base.phase_ms[0], base.phase_ms[1], base.phase_ms[2]},
+            .flags = base.flags,
+            .misses = fields[5],
+            .pedestrian_calls = fields[6],
+            .vehicles = fields[7],
+        };
+    }
+    return true;
+}
@@ -0,0 +1,71 @@
+#ifndef CYCLELOG_CODEC_H
+#define CYCLELOG_CODEC_H
+
+// Codificação das páginas do registro de ciclos: cada página de 256 bytes é decodificável sozinha.
+// O cabeçalho guarda o estado anterior à primeira entrada; cada entrada é um byte de máscara seguido
+// apenas dos campos não nulos, em varint: diferenças (zigzag) em relação à entrada anterior para
+// intervalo entre ciclos e durações das fases, XOR para os modos e contagens absolutas por ciclo.
+// Em tempo fixo, um ciclo igual ao anterior ocupa um único byte. Não depende do SDK do Pico;
+// tools/cyclelog_decode.py implementa a mesma decodificação no host.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define CYCLELOG_PAGE_SIZE 256
+#define CYCLELOG_PAGE_MAGIC 0xC1C7
+#define CYCLELOG_HEADER_SIZE 37
+#define CYCLELOG_FIELD_COUNT 8
+#define CYCLELOG_RECORD_MAX_SIZE (1 + CYCLELOG_FIELD_COUNT * 5)
+
+// Modos ativos durante o ciclo
+#define CYCLELOG_FLAG_NIGHT (1u << 0)
+#define CYCLELOG_FLAG_FAULT (1u << 1)
+#define CYCLELOG_FLAG_ACTUATED (1u << 2)
+#define CYCLELOG_FLAG_COORDINATED (1u << 3)
+#define CYCLELOG_FLAG_ADAPTIVE (1u << 4)
+
+typedef struct cyclelog_record_t
+{
+    uint32_t start_ms;         // Início do ciclo (ms desde o boot)
+    uint32_t phase_ms[3];      // Duração efetiva de verde, amarelo e vermelho
+    uint8_t flags;             // CYCLELOG_FLAG_*
+    uint32_t misses;           // Perdas de prazo durante o ciclo
+    uint32_t pedestrian_calls; // Chamadas de pedestre atendidas
+    uint32_t vehicles;         // Veículos contados pelos detectores
+} cyclelog_record_t;
+
+// Estado de referência das diferenças (a última entrada codificada).
+typedef struct cyclelog_base_t
+{
+    uint32_t start_ms;
+    uint32_t interval_ms;
+    uint32_t phase_ms[3];
+    uint8_t flags;
+} cyclelog_base_t;
+
+typedef struct cyclelog_page_t
+{
+    uint8_t data[CYCLELOG_PAGE_SIZE];
+    uint16_t used;        // Bytes ocupados, incluindo o cabeçalho
+    uint8_t count;        // Entradas na página
+    cyclelog_base_t base; // Referência para a próxima entrada
+} cyclelog_page_t;
+
+typedef struct cyclelog_page_info_t
+{
+    uint16_t boot;
+    uint32_t sequence;
+    uint8_t count;
+    uint16_t used;
+    uint32_t first_ms; // Início anterior à primeira entrada (limite inferior do intervalo)
+    uint32_t last_ms;  // Início da última entrada
+} cyclelog_page_info_t;
+
+uint8_t cyclelog_crc8(uint8_t crc, const uint8_t *data, uint16_t length);
+void cyclelog_page_open(cyclelog_page_t *page, const cyclelog_base_t *base);
+bool cyclelog_page_append(cyclelog_page_t *page, const cyclelog_record_t *record);
+void cyclelog_page_seal(cyclelog_page_t *page, uint16_t boot, uint32_t sequence);
+bool cyclelog_page_parse(const uint8_t data[CYCLELOG_PAGE_SIZE], cyclelog_page_info_t *info);
+bool cyclelog_page_decode(const uint8_t data[CYCLELOG_PAGE_SIZE], cyclelog_record_t *records, uint8_t max_count);
+
+#endif // CYCLELOG_CODEC_H
@@ -0,0 +1,202 @@
+#include "detector.h"
+#include "hardware/dma.h"
+#include "hardware/sync.h"
+#include "log/log.h"
+
+// O anel de escrita do DMA exige o buffer alinhado ao próprio tamanho. Com 4 canais a 100 kHz,
+// 1024 palavras cobrem ~82 ms: quatro períodos da tarefa que processa o buffer.
+static uint32_t ring[DETECTOR_RING_WORDS] __attribute__((aligned(1u << DETECTOR_RING_BITS)));
+static const uint32_t ring_transfer_count = DETECTOR_RING_WORDS;
+
+static PIO pio;
+static uint sm;
+static int data_chan = -1;
+static int reload_chan = -1;
+
+static detector_core_t core;
+static uint32_t tail = 0;          // Próxima palavra a processar
+static uint64_t last_poll_us = 0;
+static uint64_t window_begin_us = 0;
+
+// Estatísticas do processamento em lote
+static uint32_t overruns = 0;
+static uint64_t busy_us = 0;       // Tempo de CPU no processamento desde o início da janela
+static detector_window_t last_windows[DETECTOR_CHANNELS]; // Última janela encerrada
+static uint32_t last_window_ms = 0;
+static uint32_t last_load_permille = 0;
+
+// Toma posse de uma máquina livre, preferindo pio1 (pio0 hospeda a matriz de LEDs).
+static void claim_state_machine(uint *offset)
+{
+    PIO blocks[2] = {pio1, pio0};
+    for (uint i = 0; i < 2; i++)
+    {
+        if (!pio_can_add_program(blocks[i], &detector_sampler_program))
+            continue;
+
+        int claimed = pio_claim_unused_sm(blocks[i], i == 1); // Se nenhuma máquina estiver livre, panic!
+        if (claimed < 0)
+            continue;
+
+        pio = blocks[i];
+        sm = claimed;
+        *offset = pio_add_program(pio, &detector_sampler_program);
+        return;
+    }
+    panic("detector: sem máquina PIO livre");
+}
+
+// Configura os pinos, a máquina de amostragem e os dois canais DMA que a mantêm escrevendo no
+// buffer circular indefinidamente: ao fim de cada volta, o canal de recarga reescreve a contagem.
+void detector_init(detector_edge_t on_edge, void *context)
+{
+    detector_config_t config = {
+        .channels = DETECTOR_CHANNELS,
+        .sample_us = 1000000 / DETECTOR_SAMPLE_HZ,
+        .filter_us = DETECTOR_FILTER_US,
+        .on_edge = on_edge,
+        .context = context,
+    };
+    detector_core_init(&core, &config);
+
+    for (uint i = 0; i < DETECTOR_CHANNELS; i++)
+        gpio_pull_up(DETECTOR_PIN_BASE + i);
+
+    uint offset;
+    claim_state_machine(&offset);
+
+    data_chan = dma_claim_unused_channel(true); // Se nenhum canal estiver livre, panic!
+    reload_chan = dma_claim_unused_channel(true);
+
+    dma_channel_config data = dma_channel_get_default_config(data_chan);
+    channel_config_set_transfer_data_size(&data, DMA_SIZE_32);
+    channel_config_set_read_increment(&data, false);
+    channel_config_set_write_increment(&data, true);
+    channel_config_set_ring(&data, true, DETECTOR_RING_BITS); // O endereço de escrita dá a volta sozinho
+    channel_config_set_dreq(&data, pio_get_dreq(pio, sm, false));
+    channel_config_set_chain_to(&data, reload_chan);
+    dma_channel_configure(data_chan, &data, ring, &pio->rxf[sm], DETECTOR_RING_WORDS, false);
+
+    dma_channel_config reload = dma_channel_get_default_config(reload_chan);
+    channel_config_set_transfer_data_size(&reload, DMA_SIZE_32);
+    channel_config_set_read_increment(&reload, false);
+    channel_config_set_write_increment(&reload, false);
+    dma_channel_configure(reload_chan, &reload, &dma_hw->ch[data_chan].al1_transfer_count_trig,
+                          &ring_transfer_count, 1, false);
+
+    dma_channel_start(data_chan);
+    detector_sampler_program_init(pio, sm, offset, DETECTOR_PIN_BASE, DETECTOR_SAMPLE_HZ, DETECTOR_ACTIVE_LOW);
+
+    // Laços livres leem 0 depois da inversão; um canal ocupado no boot é um veículo parado sobre o laço
+    // ou uma inversão perdida, que faria todos os laços livres parecerem ocupados
+    uint32_t channel_mask = (1u << DETECTOR_CHANNELS) - 1;
+    uint32_t occupied = (gpio_get_all() >> DETECTOR_PIN_BASE) & channel_mask;
+    if (occupied)
+        LOG1(LOG_DETECTOR_OCCUPIED_AT_BOOT, occupied);
+
+    last_poll_us = time_us_64();
+    window_begin_us = last_poll_us;
+}
+
+// Recalcula o divisor da amostragem; com clk_sys múltiplo de 100 kHz o período continua exato.
+void detector_set_clock(uint32_t sys_hz)
+{
+    if (data_chan < 0)
+        return;
+
+    pio_sm_set_clkdiv(pio, sm, detector_sampler_program_clkdiv(sys_hz, DETECTOR_SAMPLE_HZ));
+}
+
+// Encerra a janela atual: guarda as estatísticas de cada canal e a carga de CPU do processamento.
+static void close_window(uint64_t now_us)
+{
+    detector_window_t windows[DETECTOR_CHANNELS];
+    for (uint8_t c = 0; c < DETECTOR_CHANNELS; c++)
+        detector_core_read_window(&core, c, &windows[c]);
+    detector_core_start_window(&core);
+
+    uint64_t span_us = now_us - window_begin_us;
+    uint32_t irq_state = save_and_disable_interrupts();
+    for (uint8_t c = 0; c < DETECTOR_CHANNELS; c++)
+        last_windows[c] = windows[c];
+    last_window_ms = (uint32_t)(span_us / 1000);
+    last_load_permille = span_us ? (uint32_t)(busy_us * 1000 / span_us) : 0;
+    restore_interrupts(irq_state);
+
+    busy_us = 0;
+    window_begin_us = now_us;
+}
+
+// Processa as palavras escritas pelo DMA desde a última chamada; retorna quantas foram processadas.
+uint32_t detector_poll()
+{
+    uint64_t begin_us = time_us_64();
+    uint32_t head = ((uintptr_t)dma_hw->ch[data_chan].write_addr - (uintptr_t)ring) / sizeof(uint32_t);
+    head &= DETECTOR_RING_WORDS - 1;
+    uint32_t available = (head - tail) & (DETECTOR_RING_WORDS - 1);
+
+    // A posição do DMA não distingue voltas completas: o tempo decorrido diz quantas palavras chegaram
+    uint32_t expected = (uint32_t)((begin_us - last_poll_us) * DETECTOR_CHANNELS * DETECTOR_SAMPLE_HZ /
+                                   (32 * 1000000ull));
+    last_poll_us = begin_us;
+    if (expected + DETECTOR_RING_GUARD_WORDS >= DETECTOR_RING_WORDS)
+    {
+        detector_core_skip(&core, expected);
+        tail = head;
+        overruns++;
+        LOG1(LOG_DETECTOR_OVERRUN, expected);
+        return 0;
+    }
+
+    // Até duas partes contíguas: do fim da última leitura ao fim do buffer, e do início até a cabeça
+    uint32_t first = MIN(available, DETECTOR_RING_WORDS - tail);
+    detector_core_process(&core, &ring[tail], first);
+    if (available > first)
+        detector_core_process(&core, ring, available - first);
+    tail = head;
+
+    uint64_t end_us = time_us_64();
+    busy_us += end_us - begin_us;
+    if (end_us - window_begin_us >= DETECTOR_WINDOW_MS * 1000ull)
+        close_window(end_us);
+    return available;
+}
+
+// Canais ocupados (bit por canal), segundo o último lote processado.
+uint32_t detector_occupied_mask()
+{
+    return core.levels;
+}
+
+// Veículos contados em todos os canais desde o boot.
+uint32_t detector_vehicle_total()
+{
+    uint32_t total = 0;
+    for (uint8_t c = 0; c < DETECTOR_CHANNELS; c++)
+        total += core.channel[c].count;
+    return total;
+}
+
+// Imprime a contagem, a ocupação e o headway de cada canal na última janela encerrada.
+void detector_report()
+{
+    detector_window_t windows[DETECTOR_CHANNELS];
+    uint32_t irq_state = save_and_disable_interrupts();
+    for (uint8_t c = 0; c < DETECTOR_CHANNELS; c++)
+        windows[c] = last_windows[c];
+    uint32_t window_ms = last_window_ms;
+    uint32_t load = last_load_permille;
+    restore_interrupts(irq_state);
+
+    printf("detector;janela_ms;%lu;carga;%lu.%lu%%;sobrescritas;%lu\n", (unsigned long)window_ms,
+           (unsigned long)(load / 10), (unsigned long)(load % 10), (unsigned long)overruns);
+    printf("canal;ocupado;veiculos;ocupacao;headway_us;headway_medio_us;headway_min_us;descartados\n");
+    for (uint8_t c = 0; c < DETECTOR_CHANNELS; c++)
+    {
+        printf("%u;%s;%lu;%lu.%lu%%;%lu;%lu;%lu;%lu\n", c, windows[c].occupied ? "sim" : "nao",
+               (unsigned long)windows[c].count, (unsigned long)(windows[c].occupancy_permille / 10),
+               (unsigned long)(windows[c].occupancy_permille % 10), (unsigned long)windows[c].last_headway_us,
+               (unsigned long)windows[c].mean_headway_us, (unsigned long)windows[c].min_headway_us,
+               (unsigned long)windows[c].rejected);
+    }
+}
@@ -0,0 +1,27 @@
+#ifndef DETECTOR_H
+#define DETECTOR_H
+
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "detector_core.h"
+#include "detector.pio.h"
+
+#define DETECTOR_PIN_BASE 16                         // Canais em pinos consecutivos: GP16..GP19
+#define DETECTOR_CHANNELS detector_sampler_CHANNELS  // Definido no programa PIO
+#define DETECTOR_ACTIVE_LOW true                     // Saídas de coletor aberto: ocupado em nível baixo
+#define DETECTOR_SAMPLE_HZ 100000                    // Resolução de 10 us nos instantes das bordas
+#define DETECTOR_FILTER_US 50                        // Pulsos mais curtos são ruído
+#define DETECTOR_RING_BITS 12                        // Buffer circular de 4 KiB (alinhado ao tamanho)
+#define DETECTOR_RING_WORDS ((1u << DETECTOR_RING_BITS) / sizeof(uint32_t))
+#define DETECTOR_RING_GUARD_WORDS 16                 // Margem na detecção de sobrescrita do buffer
+#define DETECTOR_BATCH_MS 20                         // Período da tarefa que processa o buffer
+#define DETECTOR_WINDOW_MS 30000                     // Janela de contagem e ocupação
+
+void detector_init(detector_edge_t on_edge, void *context);
+void detector_set_clock(uint32_t sys_hz);
+uint32_t detector_poll();
+uint32_t detector_occupied_mask();
+uint32_t detector_vehicle_total();
+void detector_report();
+
+#endif // DETECTOR_H
@@ -0,0 +1,154 @@
+#include "detector_core.h"
+
+// Configura o núcleo; retorna false se o número de canais não divide a palavra de 32 bits.
+bool detector_core_init(detector_core_t *core, const detector_config_t *config)
+{
+    uint8_t channels = config->channels;
+    if (channels == 0 || channels > DETECTOR_MAX_CHANNELS || 32 % channels != 0 || config->sample_us == 0)
+        return false;
+
+    *core = (detector_core_t){.config = *config};
+    core->samples_per_word = 32 / channels;
+    core->channel_mask = (1u << channels) - 1;
+    for (uint8_t k = 0; k < core->samples_per_word; k++)
+        core->replicate |= 1u << (k * channels);
+    core->filter_samples = config->filter_us / config->sample_us;
+    if (core->filter_samples == 0)
+        core->filter_samples = 1;
+    return true;
+}
+
+// Efetiva a mudança de nível de um canal a partir da amostra edge.
+static void accept_edge(detector_core_t *core, uint8_t c, uint64_t edge)
+{
+    detector_channel_t *channel = &core->channel[c];
+    core->pending_mask &= ~(1u << c);
+    core->levels ^= 1u << c;
+    channel->occupied = !channel->occupied;
+
+    if (channel->occupied)
+    {
+        channel->count++;
+        channel->window_count++;
+        if (channel->has_onset)
+        {
+            uint32_t headway_us = (uint32_t)((edge - channel->onset_sample) * core->config.sample_us);
+            channel->last_headway_us = headway_us;
+            channel->sum_headway_us += headway_us;
+            if (channel->headways == 0 || headway_us < channel->min_headway_us)
+                channel->min_headway_us = headway_us;
+            channel->headways++;
+        }
+        channel->onset_sample = edge;
+        channel->has_onset = true;
+    }
+    else
+    {
+        uint64_t from = channel->onset_sample > core->window_start ? channel->onset_sample : core->window_start;
+        channel->on_samples += edge - from;
+    }
+
+    if (core->config.on_edge)
+        core->config.on_edge(core->config.context, c, channel->occupied, edge * core->config.sample_us);
+}
+
+// Avalia uma amostra nos canais que mudaram ou que aguardam o filtro.
+static void process_sample(detector_core_t *core, uint32_t raw)
+{
+    uint32_t candidates = (raw ^ core->levels) | core->pending_mask;
+    while (candidates)
+    {
+        uint8_t c = __builtin_ctz(candidates);
+        candidates &= candidates - 1;
+        uint32_t bit = 1u << c;
+        detector_channel_t *channel = &core->channel[c];
+
+        if ((raw & bit) == (core->levels & bit))
+        {
+            // Voltou ao nível aceito antes do filtro: pulso descartado
+            core->pending_mask &= ~bit;
+            channel->rejected++;
+            continue;
+        }
+
+        if (!(core->pending_mask & bit))
+        {
+            core->pending_mask |= bit;
+            channel->pending_sample = core->sample;
+        }
+        if (core->sample - channel->pending_sample + 1 >= core->filter_samples)
+            accept_edge(core, c, channel->pending_sample);
+    }
+    core->sample++;
+}
+
+// Processa um lote de palavras capturadas, na ordem em que foram amostradas.
+void detector_core_process(detector_core_t *core, const uint32_t *words, uint32_t count)
+{
+    uint8_t channels = core->config.channels;
+    uint8_t samples = core->samples_per_word;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t word = words[i];
+
+        // Sem bordas na palavra (o caso comum): avança o tempo sem olhar amostra por amostra
+        if (!core->pending_mask && word == core->levels * core->replicate)
+        {
+            core->sample += samples;
+            core->quiet_words++;
+            continue;
+        }
+
+        for (int k = samples - 1; k >= 0; k--)
+            process_sample(core, (word >> (k * channels)) & core->channel_mask);
+    }
+    core->words += count;
+}
+
+// Avança o tempo sobre palavras perdidas (buffer sobrescrito), mantendo os níveis aceitos.
+void detector_core_skip(detector_core_t *core, uint32_t words)
+{
+    core->sample += (uint64_t)words * core->samples_per_word;
+    core->pending_mask = 0;
+}
+
+// Instante da próxima amostra, em microssegundos desde o início da captura.
+uint64_t detector_core_time_us(const detector_core_t *core)
+{
+    return core->sample * core->config.sample_us;
+}
+
+void detector_core_read_window(const detector_core_t *core, uint8_t c, detector_window_t *window)
+{
+    const detector_channel_t *channel = &core->channel[c];
+    uint64_t on_samples = channel->on_samples;
+    if (channel->occupied)
+    {
+        // Ocupação em andamento conta até a amostra atual
+        uint64_t from = channel->onset_sample > core->window_start ? channel->onset_sample : core->window_start;
+        on_samples += core->sample - from;
+    }
+
+    uint64_t span = core->sample - core->window_start;
+    *window = (detector_window_t){
+        .occupied = channel->occupied,
+        .count = channel->window_count,
+        .occupancy_permille = span ? (uint32_t)(on_samples * 1000 / span) : 0,
+        .last_headway_us = channel->last_headway_us,
+        .mean_headway_us = channel->headways ? (uint32_t)(channel->sum_headway_us / channel->headways) : 0,
+        .min_headway_us = channel->min_headway_us,
+        .rejected = channel->rejected,
+    };
+}
+
+// Inicia uma nova janela de ocupação e contagem a partir da amostra atual.
+void detector_core_start_window(detector_core_t *core)
+{
+    core->window_start = core->sample;
+    for (uint8_t c = 0; c < core->config.channels; c++)
+    {
+        core->channel[c].on_samples = 0;
+        core->channel[c].window_count = 0;
+    }
+}
@@ -0,0 +1,79 @@
+#ifndef DETECTOR_CORE_H
+#define DETECTOR_CORE_H
+
+// Núcleo portátil dos detectores veiculares: extrai as bordas das palavras de amostras capturadas
+// pela PIO e calcula contagem, ocupação e headway por canal. Não depende do SDK do Pico;
+// tools/detector_replay.c o usa no Linux com trens de pulsos gravados ou sintéticos.
+//
+// Cada palavra de 32 bits carrega 32 / channels amostras consecutivas, a mais antiga nos bits altos;
+// em cada amostra, o bit c é o nível do canal c (1: ocupado).
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define DETECTOR_MAX_CHANNELS 8
+
+// Chamada a cada borda aceita pelo filtro, com o instante da primeira amostra do novo nível.
+typedef void (*detector_edge_t)(void *context, uint8_t channel, bool occupied, uint64_t time_us);
+
+typedef struct detector_config_t
+{
+    uint8_t channels;        // Canais por amostra: 1, 2, 4 ou 8
+    uint32_t sample_us;      // Período de amostragem
+    uint32_t filter_us;      // Tempo que um novo nível deve persistir para ser aceito (0: sem filtro)
+    detector_edge_t on_edge; // Opcional
+    void *context;
+} detector_config_t;
+
+typedef struct detector_channel_t
+{
+    bool occupied;              // Nível aceito
+    bool has_onset;             // Já houve uma subida (headway definido a partir da segunda)
+    uint64_t pending_sample;    // Primeira amostra do nível aguardando o filtro
+    uint64_t onset_sample;      // Início da ocupação atual (ou da última)
+    uint64_t on_samples;        // Amostras ocupadas encerradas na janela atual
+    uint32_t count;             // Veículos (subidas aceitas) desde o início
+    uint32_t window_count;      // Veículos na janela atual
+    uint32_t rejected;          // Pulsos descartados pelo filtro
+    uint32_t headways;          // Intervalos entre subidas medidos
+    uint32_t last_headway_us;
+    uint32_t min_headway_us;
+    uint64_t sum_headway_us;
+} detector_channel_t;
+
+typedef struct detector_core_t
+{
+    detector_config_t config;
+    uint8_t samples_per_word;
+    uint32_t channel_mask;      // Bits de uma amostra
+    uint32_t replicate;         // Multiplicador que repete uma amostra em toda a palavra
+    uint32_t filter_samples;
+    uint32_t levels;            // Níveis aceitos (bit por canal)
+    uint32_t pending_mask;      // Canais com mudança aguardando o filtro
+    uint64_t sample;            // Índice da próxima amostra
+    uint64_t window_start;      // Primeira amostra da janela de ocupação
+    uint64_t words;             // Palavras processadas
+    uint64_t quiet_words;       // Palavras sem mudança (caminho rápido)
+    detector_channel_t channel[DETECTOR_MAX_CHANNELS];
+} detector_core_t;
+
+// Estatísticas de um canal na janela atual.
+typedef struct detector_window_t
+{
+    bool occupied;
+    uint32_t count;              // Veículos na janela
+    uint32_t occupancy_permille; // Fração da janela com o canal ocupado
+    uint32_t last_headway_us;
+    uint32_t mean_headway_us;    // Média desde o início
+    uint32_t min_headway_us;
+    uint32_t rejected;           // Desde o início
+} detector_window_t;
+
+bool detector_core_init(detector_core_t *core, const detector_config_t *config);
+void detector_core_process(detector_core_t *core, const uint32_t *words, uint32_t count);
+void detector_core_skip(detector_core_t *core, uint32_t words);
+uint64_t detector_core_time_us(const detector_core_t *core);
+void detector_core_read_window(const detector_core_t *core, uint8_t channel, detector_window_t *window);
+void detector_core_start_window(detector_core_t *core);
+
+#endif // DETECTOR_CORE_H
@@ -0,0 +1,29 @@
+#ifndef HAL_BOARD_HPP
+#define HAL_BOARD_HPP
+
+// Periféricos da placa como tipos da HAL, a partir dos mesmos pinos declarados pelas bibliotecas em C.
+
+#include "hal.hpp"
+#include "led/led.h"
+#include "buzzer/buzzer.h"
+#include "ssd1306/display.h"
+#include "ws2812b.pio.h"
+
+namespace board
+{
+
+using led_green = hal::pin<GREEN_LED_PIN>;
+using led_blue = hal::pin<BLUE_LED_PIN>;
+using led_red = hal::pin<RED_LED_PIN>;
+using rgb_led = hal::pin_group<led_red, led_green, led_blue>;
+
+using buzzer_a = hal::tone<BUZZER_A_PIN, BUZZER_COUNTER_HZ>;
+using buzzer_b = hal::tone<BUZZER_B_PIN, BUZZER_COUNTER_HZ>;
+
+using display = hal::i2c_device<1, SSD1306_I2C_SDA, SSD1306_I2C_SCL, SSD1306_ADDRESS>; // SSD1306_I2C_PORT
+
+using matrix_program = hal::pio_program_slot<0, &led_matrix_program>;
+
+} // namespace board
+
+#endif // HAL_BOARD_HPP
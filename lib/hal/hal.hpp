@@ -0,0 +1,197 @@
+#ifndef HAL_HPP
+#define HAL_HPP
+
+// Camada de abstração de hardware em C++17, apenas em cabeçalho. Pinos, slices PWM, programas PIO e
+// dispositivos I2C são tipos: número do pino, máscara, slice, canal, DREQ e instância são constantes
+// de compilação, e os métodos estáticos se reduzem às mesmas escritas de registrador que o código C
+// escrito à mão. Não guarda estado próprio, então convive com as APIs em C de lib/ nos mesmos
+// periféricos. Configurações inválidas (pino inexistente, pino sem a função I2C da instância, pino
+// repetido em um grupo) são erros de compilação.
+
+#include "pico/stdlib.h"
+#include "hardware/gpio.h"
+#include "hardware/i2c.h"
+#include "hardware/pio.h"
+#include "hardware/pwm.h"
+
+namespace hal
+{
+
+template <uint Pin>
+struct pin
+{
+    static_assert(Pin < NUM_BANK0_GPIOS, "pino inexistente no RP2040");
+
+    static constexpr uint number = Pin;
+    static constexpr uint32_t mask = 1u << Pin;
+
+    static void init_output()
+    {
+        gpio_init(Pin);
+        gpio_set_dir(Pin, GPIO_OUT);
+    }
+
+    static void init_input_pull_up()
+    {
+        gpio_init(Pin);
+        gpio_set_dir(Pin, GPIO_IN);
+        gpio_pull_up(Pin);
+    }
+
+    static void put(bool value) { gpio_put(Pin, value); }
+    static bool get() { return gpio_get(Pin); }
+};
+
+// Pinos escritos juntos: qualquer combinação de níveis sai em um único acesso mascarado ao SIO,
+// sem estados intermediários visíveis entre um pino e outro.
+template <typename... Pins>
+struct pin_group
+{
+    static_assert(sizeof...(Pins) > 0, "grupo vazio");
+
+    static constexpr uint32_t mask = (Pins::mask | ...);
+    static_assert((Pins::mask + ...) == mask, "pino repetido no grupo");
+
+    // Valor com os pinos On em nível alto e os demais do grupo em nível baixo.
+    template <typename... On>
+    static constexpr uint32_t value()
+    {
+        constexpr uint32_t bits = (0u | ... | On::mask);
+        static_assert((bits & ~mask) == 0, "pino fora do grupo");
+        return bits;
+    }
+
+    static void init_output()
+    {
+        gpio_init_mask(mask);
+        gpio_set_dir_out_masked(mask);
+    }
+
+    static void put(uint32_t value) { gpio_put_masked(mask, value); }
+    static void clear() { gpio_clr_mask(mask); }
+
+    template <typename... On>
+    static void set() { put(value<On...>()); }
+};
+
+// Saída PWM: slice e canal são fixos para cada pino.
+template <uint Pin>
+struct pwm_pin
+{
+    static_assert(Pin < NUM_BANK0_GPIOS, "pino inexistente no RP2040");
+
+    static constexpr uint number = Pin;
+    static constexpr uint slice = (Pin >> 1u) & 7u;
+    static constexpr uint channel = Pin & 1u;
+
+    static void init(float clkdiv)
+    {
+        gpio_set_function(Pin, GPIO_FUNC_PWM);
+        pwm_config config = pwm_get_default_config();
+        pwm_config_set_clkdiv(&config, clkdiv);
+        pwm_init(slice, &config, true);
+        set_level(0);
+    }
+
+    static void set_clkdiv(float clkdiv) { pwm_set_clkdiv(slice, clkdiv); }
+    static void set_wrap(uint16_t top) { pwm_set_wrap(slice, top); }
+    static void set_level(uint16_t level) { pwm_set_chan_level(slice, channel, level); }
+};
+
+// Gerador de tom em um pino PWM com o contador em CounterHz (o divisor acompanha o clk_sys).
+template <uint Pin, uint32_t CounterHz>
+struct tone : pwm_pin<Pin>
+{
+    static_assert(CounterHz > 0, "frequência do contador inválida");
+
+    // Wrap para uma frequência; com frequência constante, dobra em tempo de compilação.
+    static constexpr uint16_t top_for(uint frequency)
+    {
+        uint32_t top = CounterHz / frequency - 1;
+        return top > 0xFFFF ? 0xFFFF : (uint16_t)top;
+    }
+
+    static void init(uint32_t sys_hz) { pwm_pin<Pin>::init((float)sys_hz / CounterHz); }
+    static void set_clock(uint32_t sys_hz) { pwm_pin<Pin>::set_clkdiv((float)sys_hz / CounterHz); }
+
+    static void play(uint frequency)
+    {
+        if (frequency == 0)
+            return;
+
+        uint16_t top = top_for(frequency);
+        pwm_pin<Pin>::set_wrap(top);
+        pwm_pin<Pin>::set_level(top / 2); // 50% de duty cycle
+    }
+
+    static void stop() { pwm_pin<Pin>::set_level(0); }
+};
+
+// Bloco PIO e um programa carregado nele.
+template <uint Index, const pio_program_t *Program>
+struct pio_program_slot
+{
+    static_assert(Index < NUM_PIOS, "bloco PIO inexistente");
+
+    static PIO block() { return Index ? pio1 : pio0; }
+    static bool can_load() { return pio_can_add_program(block(), Program); }
+    static uint load() { return pio_add_program(block(), Program); }
+    static uint claim_sm() { return (uint)pio_claim_unused_sm(block(), true); } // Sem máquina livre, panic!
+};
+
+// Máquina de estados fixa: FIFOs e DREQs sem consulta em tempo de execução.
+template <uint Index, uint Sm>
+struct pio_sm
+{
+    static_assert(Index < NUM_PIOS && Sm < NUM_PIO_STATE_MACHINES, "máquina PIO inexistente");
+
+    static constexpr uint tx_dreq = Index * 8 + Sm;     // DREQ_PIO0_TX0 + ...
+    static constexpr uint rx_dreq = Index * 8 + 4 + Sm; // DREQ_PIO0_RX0 + ...
+
+    static PIO block() { return Index ? pio1 : pio0; }
+    static volatile uint32_t *tx_fifo() { return &block()->txf[Sm]; }
+    static volatile uint32_t *rx_fifo() { return &block()->rxf[Sm]; }
+    static void put(uint32_t data) { pio_sm_put(block(), Sm, data); }
+    static void put_blocking(uint32_t data) { pio_sm_put_blocking(block(), Sm, data); }
+    static void set_enabled(bool enabled) { pio_sm_set_enabled(block(), Sm, enabled); }
+};
+
+// Dispositivo em um barramento I2C. No RP2040, SDA e SCL da instância n ficam nos pinos com
+// resto 2n e 2n + 1 na divisão por 4.
+template <uint Instance, uint Sda, uint Scl, uint8_t Address>
+struct i2c_device
+{
+    static_assert(Instance < NUM_I2CS, "instância I2C inexistente");
+    static_assert(Sda < NUM_BANK0_GPIOS && Sda % 4 == 2 * Instance, "pino sem a função SDA desta instância");
+    static_assert(Scl < NUM_BANK0_GPIOS && Scl % 4 == 2 * Instance + 1, "pino sem a função SCL desta instância");
+    static_assert(Address < 0x80, "endereço I2C de 7 bits");
+
+    static constexpr uint8_t address = Address;
+
+    static i2c_inst_t *port() { return Instance ? i2c1 : i2c0; }
+
+    // Retorna a taxa efetiva do barramento.
+    static uint init(uint baudrate)
+    {
+        uint actual = i2c_init(port(), baudrate);
+        gpio_set_function(Sda, GPIO_FUNC_I2C);
+        gpio_set_function(Scl, GPIO_FUNC_I2C);
+        gpio_pull_up(Sda);
+        gpio_pull_up(Scl);
+        return actual;
+    }
+
+    static int write(const uint8_t *data, size_t length, bool nostop = false)
+    {
+        return i2c_write_blocking(port(), Address, data, length, nostop);
+    }
+
+    static int read(uint8_t *data, size_t length, bool nostop = false)
+    {
+        return i2c_read_blocking(port(), Address, data, length, nostop);
+    }
+};
+
+} // namespace hal
+
+#endif // HAL_HPP
@@ -0,0 +1,108 @@
+#include <cstdio>
+#include "hal_benchmark.h"
+#include "board.hpp"
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+
+#define HAL_BENCHMARK_CALLS 10000
+#define HAL_BENCHMARK_TONE_HZ 1950
+
+// Cada variante fica em uma função própria, sem inlining, com nome C: o custo por chamada é medido
+// igual para todas e o build imprime o tamanho de cada uma (tools/symbol_sizes.py, símbolos hal_bench_*).
+extern "C" {
+
+__attribute__((noinline)) void hal_bench_empty()
+{
+    __asm volatile("");
+}
+
+// Amarelo como em set_led_yellow antes da HAL: um gpio_put por pino, com transições intermediárias
+__attribute__((noinline)) void hal_bench_c_yellow_puts()
+{
+    gpio_put(GREEN_LED_PIN, false);
+    gpio_put(BLUE_LED_PIN, false);
+    gpio_put(RED_LED_PIN, false);
+    gpio_put(GREEN_LED_PIN, true);
+    gpio_put(RED_LED_PIN, true);
+}
+
+// Referência escrita à mão em C: uma escrita mascarada
+__attribute__((noinline)) void hal_bench_c_yellow_masked()
+{
+    gpio_put_masked(LEDS_MASK, (1u << RED_LED_PIN) | (1u << GREEN_LED_PIN));
+}
+
+__attribute__((noinline)) void hal_bench_hal_yellow()
+{
+    board::rgb_led::set<board::led_red, board::led_green>();
+}
+
+// API em C do buzzer: busca o pino na tabela e recalcula o slice a cada chamada
+__attribute__((noinline)) void hal_bench_c_tone()
+{
+    play_tone(BUZZER_B_PIN, HAL_BENCHMARK_TONE_HZ);
+}
+
+// Referência escrita à mão em C com pino e frequência constantes
+__attribute__((noinline)) void hal_bench_c_tone_direct()
+{
+    uint slice = pwm_gpio_to_slice_num(BUZZER_B_PIN);
+    uint16_t top = BUZZER_COUNTER_HZ / HAL_BENCHMARK_TONE_HZ - 1;
+    pwm_set_wrap(slice, top);
+    pwm_set_chan_level(slice, pwm_gpio_to_channel(BUZZER_B_PIN), top / 2);
+}
+
+__attribute__((noinline)) void hal_bench_hal_tone()
+{
+    board::buzzer_b::play(HAL_BENCHMARK_TONE_HZ);
+}
+
+} // extern "C"
+
+struct bench_case_t
+{
+    const char *name;
+    void (*run)();
+};
+
+static const bench_case_t cases[] = {
+    {"amarelo_c_gpio_put", hal_bench_c_yellow_puts},
+    {"amarelo_c_mascarado", hal_bench_c_yellow_masked},
+    {"amarelo_hal", hal_bench_hal_yellow},
+    {"tom_c_play_tone", hal_bench_c_tone},
+    {"tom_c_direto", hal_bench_c_tone_direct},
+    {"tom_hal", hal_bench_hal_tone},
+};
+
+// Tempo de HAL_BENCHMARK_CALLS chamadas com as interrupções desligadas, em microssegundos.
+static uint32_t measure_us(void (*run)())
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+    uint32_t start_us = time_us_32();
+    for (uint i = 0; i < HAL_BENCHMARK_CALLS; i++)
+        run();
+    uint32_t elapsed_us = time_us_32() - start_us;
+    restore_interrupts(irq_state);
+    return elapsed_us;
+}
+
+// Compara, em ciclos de clk_sys por chamada, as variantes em C e na HAL das mesmas operações,
+// descontada a chamada vazia. Deixa LEDs e buzzer desligados ao final.
+void hal_benchmark()
+{
+    uint32_t mhz = clock_get_hz(clk_sys) / 1000000;
+    uint32_t empty_us = measure_us(hal_bench_empty);
+
+    printf("hal;chamadas;%u;clk_mhz;%lu\n", HAL_BENCHMARK_CALLS, (unsigned long)mhz);
+    printf("variante;ciclos_por_chamada\n");
+    for (const bench_case_t &bench : cases)
+    {
+        uint32_t elapsed_us = measure_us(bench.run);
+        uint32_t net_us = elapsed_us > empty_us ? elapsed_us - empty_us : 0;
+        uint32_t centicycles = (uint32_t)((uint64_t)net_us * mhz * 100 / HAL_BENCHMARK_CALLS);
+        printf("%s;%lu.%02lu\n", bench.name, (unsigned long)(centicycles / 100), (unsigned long)(centicycles % 100));
+    }
+
+    board::rgb_led::clear();
+    board::buzzer_b::stop();
+}
@@ -0,0 +1,14 @@
+#ifndef HAL_BENCHMARK_H
+#define HAL_BENCHMARK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void hal_benchmark();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HAL_BENCHMARK_H
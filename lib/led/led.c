@@ -13,34 +13,28 @@ void init_leds()
     init_led(RED_LED_PIN);
 }
 
+// Cada cor é uma única escrita mascarada no SIO, sem apagar os LEDs antes.
 void turn_off_leds()
 {
-    gpio_put(GREEN_LED_PIN, false);
-    gpio_put(BLUE_LED_PIN, false);
-    gpio_put(RED_LED_PIN, false);
+    gpio_put_masked(LEDS_MASK, 0);
 }
 
 void set_led_green()
 {
-    turn_off_leds();
-    gpio_put(GREEN_LED_PIN, true);
+    gpio_put_masked(LEDS_MASK, 1u << GREEN_LED_PIN);
 }
 
 void set_led_blue()
 {
-    turn_off_leds();
-    gpio_put(BLUE_LED_PIN, true);
+    gpio_put_masked(LEDS_MASK, 1u << BLUE_LED_PIN);
 }
 
 void set_led_red()
 {
-    turn_off_leds();
-    gpio_put(RED_LED_PIN, true);
+    gpio_put_masked(LEDS_MASK, 1u << RED_LED_PIN);
 }
 
 void set_led_yellow()
 {
-    turn_off_leds();
-    gpio_put(GREEN_LED_PIN, true);
-    gpio_put(RED_LED_PIN, true);
+    gpio_put_masked(LEDS_MASK, (1u << GREEN_LED_PIN) | (1u << RED_LED_PIN));
 }
\ No newline at end of file
@@ -7,6 +7,11 @@
 #define GREEN_LED_PIN 11 // GPIO para LED verde
 #define BLUE_LED_PIN 12  // GPIO para LED azul
 #define RED_LED_PIN 13   // GPIO para LED vermelho
+#define LEDS_MASK ((1u << GREEN_LED_PIN) | (1u << BLUE_LED_PIN) | (1u << RED_LED_PIN))
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 void init_led(uint8_t pin);
 void init_leds();
@@ -16,4 +21,8 @@ void set_led_blue();
 void set_led_red();
 void set_led_yellow();
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif // LED_H
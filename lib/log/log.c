@@ -0,0 +1,165 @@
+#include <stdio.h>
+#include <string.h>
+#include "log.h"
+#include "pico/stdio_usb.h"
+#include "hardware/clocks.h"
+
+#define LOG_BENCHMARK_CALLS 10000
+
+log_record_t log_ring[LOG_RING_SIZE];
+volatile uint32_t log_head = 0;
+volatile uint32_t log_tail = 0;
+volatile uint32_t log_dropped = 0;
+
+// Quadro: sincronismo, canal, tamanho, carga útil e CRC-8 da carga útil.
+#define LOG_FRAME_HEADER_SIZE 3
+#define LOG_RECORD_MAX_SIZE (6 + 4 * LOG_MAX_ARGS)
+
+// CRC-8 (polinômio 0x07) usado para validar cada quadro no host.
+static uint8_t crc8(const uint8_t *data, uint8_t length)
+{
+    uint8_t crc = 0;
+    for (uint8_t i = 0; i < length; i++)
+    {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++)
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+
+static void put_u32(uint8_t *buffer, uint32_t value)
+{
+    buffer[0] = value;
+    buffer[1] = value >> 8;
+    buffer[2] = value >> 16;
+    buffer[3] = value >> 24;
+}
+
+// Prepara o stdout para quadros binários: sem buffer de linha e sem tradução CRLF.
+void log_init()
+{
+    setvbuf(stdout, NULL, _IONBF, 0);
+    stdio_set_translate_crlf(&stdio_usb, false);
+}
+
+// Envia um quadro binário em um canal do fluxo USB (log, registro de ciclos, ...).
+// Deve ser chamada apenas pela tarefa que drena o log, para os quadros não se intercalarem.
+void log_send_frame(uint8_t channel, const uint8_t *payload, uint8_t length)
+{
+    uint8_t frame[LOG_FRAME_HEADER_SIZE + UINT8_MAX + 1]; // Uma única escrita: o stdout não tem buffer
+    frame[0] = LOG_FRAME_SYNC;
+    frame[1] = channel;
+    frame[2] = length;
+    memcpy(&frame[LOG_FRAME_HEADER_SIZE], payload, length);
+    frame[LOG_FRAME_HEADER_SIZE + length] = crc8(payload, length);
+    fwrite(frame, 1, LOG_FRAME_HEADER_SIZE + length + 1, stdout);
+}
+
+// Envia os registros pendentes ao host; chamada por uma tarefa de baixa prioridade.
+// Sem host conectado os registros são descartados, para nunca bloquear na USB.
+uint32_t log_drain()
+{
+    uint32_t sent = 0;
+
+    uint32_t dropped = log_dropped;
+    if (dropped)
+    {
+        log_dropped = 0;
+        LOG1(LOG_DROPPED, dropped);
+    }
+
+    while (log_tail != log_head)
+    {
+        log_record_t record = log_ring[log_tail & (LOG_RING_SIZE - 1)];
+        log_tail = log_tail + 1;
+
+        if (!stdio_usb_connected())
+            continue;
+
+        uint8_t payload[LOG_RECORD_MAX_SIZE];
+        uint8_t length = 6 + 4 * record.arg_count;
+        put_u32(payload, record.timestamp_us);
+        payload[4] = record.id;
+        payload[5] = record.id >> 8;
+        for (uint8_t i = 0; i < record.arg_count; i++)
+            put_u32(&payload[6 + 4 * i], record.args[i]);
+
+        log_send_frame(LOG_FRAME_CHANNEL, payload, length);
+        sent++;
+    }
+
+    return sent;
+}
+
+// Variantes medidas pelo benchmark, sem inlining, para que o custo seja o de um ponto de chamada.
+static __attribute__((noinline)) void log_bench_empty(uint32_t value)
+{
+    __asm volatile("" : : "r"(value));
+}
+
+static __attribute__((noinline)) void log_bench_log0(uint32_t value)
+{
+    LOG0(LOG_PEDESTRIAN_CALL);
+}
+
+static __attribute__((noinline)) void log_bench_log4(uint32_t value)
+{
+    LOG4(LOG_MATRIX_POINT, value, value >> 8, value >> 16, value >> 24);
+}
+
+// Referência: apenas a formatação que o printf fazia no ponto de chamada, sem a E/S.
+static __attribute__((noinline)) void log_bench_snprintf(uint32_t value)
+{
+    char text[48];
+    snprintf(text, sizeof(text), "Desenhando ponto %lu cor %lu %lu %lu\n", (unsigned long)value,
+             (unsigned long)(value >> 8), (unsigned long)(value >> 16), (unsigned long)(value >> 24));
+    __asm volatile("" : : "r"(text) : "memory");
+}
+
+// Tempo de LOG_BENCHMARK_CALLS chamadas com as interrupções desligadas, em microssegundos. O buffer
+// é esvaziado a cada meia volta, para que todas as chamadas gravem (nenhuma cai no descarte).
+static uint32_t log_bench_measure_us(void (*run)(uint32_t))
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+    uint32_t start_us = time_us_32();
+    for (uint32_t i = 0; i < LOG_BENCHMARK_CALLS; i++)
+    {
+        if ((i & (LOG_RING_SIZE / 2 - 1)) == 0)
+            log_tail = log_head;
+        run(i);
+    }
+    uint32_t elapsed_us = time_us_32() - start_us;
+    log_tail = log_head;
+    restore_interrupts(irq_state);
+    return elapsed_us;
+}
+
+// Imprime os ciclos de clk_sys por chamada de LOG0 e LOG4 e da formatação equivalente com snprintf,
+// descontado o laço com a chamada vazia. Os registros gravados são descartados.
+void log_benchmark()
+{
+    static const struct
+    {
+        const char *name;
+        void (*run)(uint32_t);
+    } cases[] = {
+        {"LOG0", log_bench_log0},
+        {"LOG4", log_bench_log4},
+        {"snprintf_4_argumentos", log_bench_snprintf},
+    };
+
+    uint32_t mhz = clock_get_hz(clk_sys) / 1000000;
+    uint32_t empty_us = log_bench_measure_us(log_bench_empty);
+
+    printf("log;chamadas;%u;clk_mhz;%lu\n", LOG_BENCHMARK_CALLS, (unsigned long)mhz);
+    printf("variante;ciclos_por_chamada\n");
+    for (uint i = 0; i < count_of(cases); i++)
+    {
+        uint32_t elapsed_us = log_bench_measure_us(cases[i].run);
+        uint32_t net_us = elapsed_us > empty_us ? elapsed_us - empty_us : 0;
+        uint32_t centicycles = (uint32_t)((uint64_t)net_us * mhz * 100 / LOG_BENCHMARK_CALLS);
+        printf("%s;%lu.%02lu\n", cases[i].name, (unsigned long)(centicycles / 100),
+               (unsigned long)(centicycles % 100));
+    }
+}
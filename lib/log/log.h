@@ -0,0 +1,64 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "log_messages.h"
+
+#define LOG_RING_SIZE 64    // Registros no buffer circular (potência de 2)
+#define LOG_MAX_ARGS 4      // Argumentos inteiros por registro
+#define LOG_FRAME_SYNC 0xA5 // Byte de sincronismo dos quadros binários
+#define LOG_FRAME_CHANNEL 0x01 // Canal dos registros de log no fluxo USB
+
+typedef struct log_record_t
+{
+    uint32_t timestamp_us;       // Instante do registro (timer de 1 MHz)
+    uint16_t id;                 // log_message_id_t
+    uint8_t arg_count;           // Argumentos válidos
+    uint8_t reserved;
+    uint32_t args[LOG_MAX_ARGS]; // Argumentos do formato
+} log_record_t;
+
+extern log_record_t log_ring[LOG_RING_SIZE];
+extern volatile uint32_t log_head;
+extern volatile uint32_t log_tail;
+extern volatile uint32_t log_dropped;
+
+void log_init();
+void log_send_frame(uint8_t channel, const uint8_t *payload, uint8_t length);
+uint32_t log_drain();
+void log_benchmark();
+
+// Grava um registro no buffer circular: sem formatação nem E/S no chamador.
+// Seguro em tarefas e interrupções; as interrupções ficam mascaradas por poucas instruções.
+static inline void log_write(uint16_t id, uint8_t arg_count, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3)
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+    uint32_t head = log_head;
+    if (head - log_tail >= LOG_RING_SIZE)
+    {
+        log_dropped++;
+    }
+    else
+    {
+        log_record_t *record = &log_ring[head & (LOG_RING_SIZE - 1)];
+        record->timestamp_us = time_us_32();
+        record->id = id;
+        record->arg_count = arg_count;
+        record->args[0] = a0;
+        record->args[1] = a1;
+        record->args[2] = a2;
+        record->args[3] = a3;
+        log_head = head + 1;
+    }
+    restore_interrupts(irq_state);
+}
+
+#define LOG0(id) log_write((id), 0, 0, 0, 0, 0)
+#define LOG1(id, a) log_write((id), 1, (uint32_t)(a), 0, 0, 0)
+#define LOG2(id, a, b) log_write((id), 2, (uint32_t)(a), (uint32_t)(b), 0, 0)
+#define LOG3(id, a, b, c) log_write((id), 3, (uint32_t)(a), (uint32_t)(b), (uint32_t)(c), 0)
+#define LOG4(id, a, b, c, d) log_write((id), 4, (uint32_t)(a), (uint32_t)(b), (uint32_t)(c), (uint32_t)(d))
+
+#endif // LOG_H
@@ -0,0 +1,34 @@
+#ifndef LOG_MESSAGES_H
+#define LOG_MESSAGES_H
+
+// Tabela de mensagens do log binário: X(identificador, formato).
+// O identificador enviado é a posição na tabela; tools/log_decode.py lê este arquivo
+// para expandir os registros. Acrescente mensagens apenas ao final da tabela.
+#define LOG_MESSAGES(X)                                                          \
+    X(LOG_NIGHT_MODE_ON, "Modo noturno: Ativado")                                \
+    X(LOG_NIGHT_MODE_OFF, "Modo noturno: Desativado")                            \
+    X(LOG_PEDESTRIAN_CALL, "Chamada de pedestre registrada")                     \
+    X(LOG_PEDESTRIAN_SERVED, "Chamada de pedestre atendida: latencia %u ms")     \
+    X(LOG_FAULT_MODE, "Falha no controle: amarelo piscante de seguranca")        \
+    X(LOG_WATCHDOG_REBOOT, "Reinicio causado pelo watchdog")                     \
+    X(LOG_MATRIX_POINT, "Desenhando ponto %u cor %u %u %u")                      \
+    X(LOG_DROPPED, "Registros de log descartados: %u")                           \
+    X(LOG_COORD_STEP, "Coordenacao: salto de fase a %u do lider, erro %d us")    \
+    X(LOG_COORD_LOST, "Coordenacao: sincronismo perdido, ciclo livre")          \
+    X(LOG_DETECTOR_OVERRUN, "Detector: buffer de captura sobrescrito, %u palavras perdidas") \
+    X(LOG_CYCLELOG_DROPPED, "Registro de ciclos: pagina %u descartada, fila de gravacao cheia") \
+    X(LOG_CYCLELOG_DISABLED, "Registro de ciclos: desabilitado, programa ocupa a regiao da flash") \
+    X(LOG_ADAPTIVE_PLAN, "Plano adaptativo: ciclo %u ms, verdes %u/%u ms, Y %u/65536") \
+    X(LOG_FAULT_RECOVERED, "Controle recuperado: fim do modo de seguranca apos %u ms sem perdas") \
+    X(LOG_COORD_SKIPPED, "Coordenacao: %u ciclos nao executados descartados") \
+    X(LOG_DETECTOR_OCCUPIED_AT_BOOT, "Detector: canais %u ocupados no boot (veiculo parado ou entrada nao invertida)")
+
+#define LOG_MESSAGE_ID(id, format) id,
+
+typedef enum
+{
+    LOG_MESSAGES(LOG_MESSAGE_ID)
+    LOG_MESSAGE_COUNT
+} log_message_id_t;
+
+#endif // LOG_MESSAGES_H
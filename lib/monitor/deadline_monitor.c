@@ -0,0 +1,275 @@
+#include "deadline_monitor.h"
+#include "hardware/sync.h"
+#include "hardware/watchdog.h"
+#include "log/log.h"
+
+typedef struct monitored_task_t
+{
+    deadline_task_stats_t stats;
+    volatile uint32_t job_begin_us; // Início do job atual (ou do último job)
+    uint32_t job_exec_begin_us;     // Tempo de CPU da tarefa no início do job
+    volatile bool in_job;           // Tarefa está executando um job
+    bool miss_flagged;              // Perda já registrada para o job/travamento atual
+    bool is_registered;
+} monitored_task_t;
+
+static monitored_task_t tasks[DEADLINE_MAX_TASKS];
+
+static deadline_miss_t miss_log[DEADLINE_MISS_LOG_SIZE];
+static uint8_t miss_log_next = 0;
+static uint8_t miss_log_count = 0;
+
+static bool watchdog_running = false;
+static bool critical_failure = false;
+static bool is_fallback = false;             // Modo de segurança acionado e ainda não recuperado
+static uint32_t last_critical_miss_ms = 0;   // Última verificação com perda crítica
+static uint32_t recoveries = 0;              // Saídas do modo de segurança desde o boot
+static bool reset_pending = false;
+static uint8_t critical_task_id = 0;
+static volatile bool late_critical_job = false; // Job crítico concluído após o prazo desde a última verificação
+static uint32_t critical_failure_since_ms = 0;
+static deadline_exec_clock_t exec_clock = NULL;
+
+// Inicializa o monitor e habilita o watchdog de hardware (0 mantém o watchdog desligado).
+void deadline_monitor_init(uint32_t watchdog_timeout_ms)
+{
+    if (watchdog_caused_reboot())
+        LOG0(LOG_WATCHDOG_REBOOT);
+
+    if (watchdog_timeout_ms > 0)
+    {
+        watchdog_enable(watchdog_timeout_ms, true); // Pausa durante depuração
+        watchdog_running = true;
+    }
+}
+
+// Declara o intervalo máximo entre liberações, o tempo máximo de resposta e o orçamento de execução
+// de uma tarefa. Com prazo 0 a tarefa não é verificada, apenas medida.
+void deadline_monitor_register(uint8_t task_id, const char *name, uint32_t period_ms, uint32_t deadline_ms,
+                               uint32_t wcet_us, bool is_critical)
+{
+    if (task_id >= DEADLINE_MAX_TASKS)
+        return;
+
+    monitored_task_t *task = &tasks[task_id];
+    task->stats = (deadline_task_stats_t){
+        .name = name,
+        .period_ms = period_ms,
+        .deadline_ms = deadline_ms,
+        .wcet_us = wcet_us,
+        .is_critical = is_critical,
+    };
+    task->job_begin_us = time_us_32();
+    task->in_job = false;
+    task->miss_flagged = false;
+    task->is_registered = true;
+}
+
+// Define a fonte do tempo de CPU por tarefa; sem ela, o tempo de execução não é medido.
+void deadline_monitor_set_exec_clock(deadline_exec_clock_t clock)
+{
+    exec_clock = clock;
+}
+
+// Registra uma perda de prazo no log circular.
+static void record_miss(uint8_t task_id, uint32_t lateness_ms, bool is_stall, deadline_severity_t severity)
+{
+    monitored_task_t *task = &tasks[task_id];
+
+    uint32_t irq_state = save_and_disable_interrupts();
+    task->stats.misses++;
+    task->miss_flagged = true;
+    miss_log[miss_log_next] = (deadline_miss_t){
+        .timestamp_ms = to_ms_since_boot(get_absolute_time()),
+        .lateness_ms = lateness_ms,
+        .task_id = task_id,
+        .severity = severity,
+        .is_stall = is_stall,
+    };
+    miss_log_next = (miss_log_next + 1) % DEADLINE_MISS_LOG_SIZE;
+    if (miss_log_count < DEADLINE_MISS_LOG_SIZE)
+        miss_log_count++;
+    restore_interrupts(irq_state);
+}
+
+// Marca o início de um job (liberação da tarefa).
+void deadline_job_begin(uint8_t task_id)
+{
+    monitored_task_t *task = &tasks[task_id];
+    task->job_begin_us = time_us_32();
+    task->job_exec_begin_us = exec_clock ? exec_clock() : 0;
+    task->miss_flagged = false;
+    task->in_job = true;
+}
+
+// Marca o fim de um job e contabiliza o tempo de resposta.
+void deadline_job_end(uint8_t task_id)
+{
+    monitored_task_t *task = &tasks[task_id];
+    uint32_t response_us = time_us_32() - task->job_begin_us;
+    uint32_t exec_us = exec_clock ? exec_clock() - task->job_exec_begin_us : 0;
+
+    task->in_job = false;
+    task->stats.jobs++;
+    task->stats.sum_response_us += response_us;
+    if (response_us > task->stats.max_response_us)
+        task->stats.max_response_us = response_us;
+    task->stats.sum_exec_us += exec_us;
+    if (exec_us > task->stats.max_exec_us)
+        task->stats.max_exec_us = exec_us;
+
+    if (task->stats.deadline_ms == 0)
+        return;
+
+    uint32_t deadline_us = task->stats.deadline_ms * 1000;
+    if (response_us > deadline_us && !task->miss_flagged)
+    {
+        record_miss(task_id, (response_us - deadline_us) / 1000, false,
+                    task->stats.is_critical ? DEADLINE_SEVERITY_CRITICAL : DEADLINE_SEVERITY_WARNING);
+        if (task->stats.is_critical)
+        {
+            critical_task_id = task_id;
+            late_critical_job = true;
+        }
+    }
+}
+
+// Verifica prazos e travamentos; alimenta o watchdog enquanto não houver falha fatal.
+// Uma falha crítica mantém o modo de segurança até DEADLINE_RECOVERY_MS sem novas perdas críticas;
+// se persistir por DEADLINE_RESET_AFTER_MS, o watchdog reinicia a placa.
+deadline_action_t deadline_monitor_check()
+{
+    uint32_t now_us = time_us_32();
+    uint32_t now_ms = now_us / 1000;
+    bool critical_miss = late_critical_job;
+    late_critical_job = false;
+
+    for (uint8_t id = 0; id < DEADLINE_MAX_TASKS; id++)
+    {
+        monitored_task_t *task = &tasks[id];
+        if (!task->is_registered || task->stats.deadline_ms == 0)
+            continue;
+
+        uint32_t elapsed_ms = (now_us - task->job_begin_us) / 1000;
+        uint32_t limit_ms = task->stats.deadline_ms;
+        if (!task->in_job)
+            limit_ms += task->stats.period_ms; // Fora do job, a tarefa deve ser liberada em até um período
+
+        if (elapsed_ms > limit_ms)
+        {
+            if (!task->miss_flagged)
+                record_miss(id, elapsed_ms - limit_ms, !task->in_job,
+                            task->stats.is_critical ? DEADLINE_SEVERITY_CRITICAL : DEADLINE_SEVERITY_WARNING);
+            if (task->stats.is_critical)
+            {
+                critical_miss = true;
+                critical_task_id = id;
+            }
+        }
+    }
+
+    if (critical_miss)
+        last_critical_miss_ms = now_ms;
+
+    if (!critical_miss)
+    {
+        critical_failure = false;
+    }
+    else if (!critical_failure)
+    {
+        critical_failure = true;
+        critical_failure_since_ms = now_ms;
+    }
+
+    if (critical_failure && now_ms - critical_failure_since_ms >= DEADLINE_RESET_AFTER_MS)
+    {
+        // Deixa de alimentar o watchdog: o reinício ocorre ao fim do timeout.
+        if (!reset_pending)
+        {
+            reset_pending = true;
+            record_miss(critical_task_id, now_ms - critical_failure_since_ms, true, DEADLINE_SEVERITY_FATAL);
+        }
+        return DEADLINE_ACTION_RESET;
+    }
+
+    if (watchdog_running)
+        watchdog_update();
+
+    if (critical_failure)
+    {
+        is_fallback = true;
+        return DEADLINE_ACTION_FALLBACK;
+    }
+    if (is_fallback && now_ms - last_critical_miss_ms >= DEADLINE_RECOVERY_MS)
+    {
+        is_fallback = false;
+        recoveries++;
+        return DEADLINE_ACTION_RECOVER;
+    }
+    return is_fallback ? DEADLINE_ACTION_FALLBACK : DEADLINE_ACTION_NONE;
+}
+
+// Copia as estatísticas de uma tarefa monitorada.
+bool deadline_monitor_get_stats(uint8_t task_id, deadline_task_stats_t *stats)
+{
+    if (task_id >= DEADLINE_MAX_TASKS || !tasks[task_id].is_registered)
+        return false;
+
+    *stats = tasks[task_id].stats;
+    return true;
+}
+
+// Copia as perdas de prazo mais recentes, da mais antiga para a mais nova.
+uint8_t deadline_monitor_get_misses(deadline_miss_t *misses, uint8_t max_count)
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+    uint8_t count = miss_log_count < max_count ? miss_log_count : max_count;
+    uint8_t first = (miss_log_next + DEADLINE_MISS_LOG_SIZE - count) % DEADLINE_MISS_LOG_SIZE;
+    for (uint8_t i = 0; i < count; i++)
+        misses[i] = miss_log[(first + i) % DEADLINE_MISS_LOG_SIZE];
+    restore_interrupts(irq_state);
+
+    return count;
+}
+
+// Orçamento sugerido a partir da execução máxima medida: margem e arredondamento para cima.
+static uint32_t recommended_wcet_us(uint32_t max_exec_us)
+{
+    uint32_t with_margin = max_exec_us + max_exec_us * DEADLINE_WCET_MARGIN_PERCENT / 100;
+    return (with_margin + DEADLINE_WCET_ROUND_US - 1) / DEADLINE_WCET_ROUND_US * DEADLINE_WCET_ROUND_US;
+}
+
+// Imprime as estatísticas de prazo e de execução de todas as tarefas e as perdas recentes.
+// A execução máxima acima do WCET declarado invalida a análise de escalonabilidade (tools/rta.py).
+void deadline_monitor_report()
+{
+    printf("tarefa;intervalo_max_ms;prazo_ms;jobs;perdas;resposta_max_us;resposta_media_us;"
+           "execucao_max_us;execucao_media_us;wcet_us;wcet_recomendado_us;acima_do_wcet\n");
+    for (uint8_t id = 0; id < DEADLINE_MAX_TASKS; id++)
+    {
+        deadline_task_stats_t stats;
+        if (!deadline_monitor_get_stats(id, &stats))
+            continue;
+
+        uint32_t mean_us = stats.jobs ? (uint32_t)(stats.sum_response_us / stats.jobs) : 0;
+        uint32_t mean_exec_us = stats.jobs ? (uint32_t)(stats.sum_exec_us / stats.jobs) : 0;
+        printf("%s;%lu;%lu;%lu;%lu;%lu;%lu;%lu;%lu;%lu;%lu;%s\n", stats.name, (unsigned long)stats.period_ms,
+               (unsigned long)stats.deadline_ms, (unsigned long)stats.jobs, (unsigned long)stats.misses,
+               (unsigned long)stats.max_response_us, (unsigned long)mean_us, (unsigned long)stats.max_exec_us,
+               (unsigned long)mean_exec_us, (unsigned long)stats.wcet_us,
+               (unsigned long)recommended_wcet_us(stats.max_exec_us),
+               stats.max_exec_us > stats.wcet_us ? "sim" : "nao");
+    }
+
+    printf("recuperacoes_do_modo_de_seguranca;%lu\n", (unsigned long)recoveries);
+
+    deadline_miss_t misses[DEADLINE_MISS_LOG_SIZE];
+    uint8_t count = deadline_monitor_get_misses(misses, DEADLINE_MISS_LOG_SIZE);
+    for (uint8_t i = 0; i < count; i++)
+    {
+        static const char *severity_names[] = {"aviso", "critico", "fatal"};
+        printf("perda;%lu ms;%s;+%lu ms;%s;%s\n", (unsigned long)misses[i].timestamp_ms,
+               tasks[misses[i].task_id].stats.name, (unsigned long)misses[i].lateness_ms,
+               misses[i].is_stall ? "travada" : "atrasada", severity_names[misses[i].severity]);
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef DEADLINE_MONITOR_H
+#define DEADLINE_MONITOR_H
+
+#include <stdlib.h>
+#include "pico/stdlib.h"
+
+#define DEADLINE_MAX_TASKS 12         // Número máximo de tarefas monitoradas
+#define DEADLINE_MISS_LOG_SIZE 16     // Registros de perda de prazo mantidos em memória
+#define DEADLINE_RESET_AFTER_MS 10000 // Tempo em falha crítica antes de deixar o watchdog reiniciar
+#define DEADLINE_RECOVERY_MS 30000    // Tempo sem perdas críticas para deixar o modo de segurança
+#define DEADLINE_WCET_MARGIN_PERCENT 25 // Margem sobre a execução máxima medida no WCET recomendado
+#define DEADLINE_WCET_ROUND_US 50       // Arredondamento do WCET recomendado
+
+typedef enum
+{
+    DEADLINE_SEVERITY_WARNING,  // Tarefa não crítica perdeu o prazo
+    DEADLINE_SEVERITY_CRITICAL, // Tarefa crítica perdeu o prazo: modo de segurança
+    DEADLINE_SEVERITY_FATAL,    // Falha crítica persistente: reinício pelo watchdog
+} deadline_severity_t;
+
+typedef enum
+{
+    DEADLINE_ACTION_NONE,     // Todas as tarefas dentro do prazo
+    DEADLINE_ACTION_FALLBACK, // Entrar (ou permanecer) no amarelo piscante de segurança
+    DEADLINE_ACTION_RECOVER,  // Controle dentro do prazo desde a falha: deixar o modo de segurança
+    DEADLINE_ACTION_RESET,    // Watchdog deixou de ser alimentado
+} deadline_action_t;
+
+typedef struct deadline_miss_t
+{
+    uint32_t timestamp_ms; // Instante em que a perda foi detectada
+    uint32_t lateness_ms;  // Quanto o prazo foi excedido
+    uint8_t task_id;       // Tarefa que perdeu o prazo
+    uint8_t severity;      // deadline_severity_t
+    bool is_stall;         // true se a tarefa deixou de ser liberada (travada fora do job)
+} deadline_miss_t;
+
+typedef struct deadline_task_stats_t
+{
+    const char *name;         // Nome da tarefa
+    uint32_t period_ms;       // Maior intervalo entre liberações (detecção de travamento)
+    uint32_t deadline_ms;     // Tempo máximo de resposta declarado (0: apenas medida)
+    uint32_t wcet_us;         // Orçamento de execução declarado no plano de tarefas
+    bool is_critical;         // Perda de prazo aciona o modo de segurança
+    uint32_t jobs;            // Jobs concluídos
+    uint32_t misses;          // Perdas de prazo registradas
+    uint32_t max_response_us; // Maior tempo de resposta observado
+    uint64_t sum_response_us; // Soma dos tempos de resposta (para a média)
+    uint32_t max_exec_us;     // Maior tempo de execução de um job (sem preempções)
+    uint64_t sum_exec_us;     // Soma dos tempos de execução (para a média)
+} deadline_task_stats_t;
+
+// Tempo de CPU acumulado pela tarefa corrente, em microssegundos.
+typedef uint32_t (*deadline_exec_clock_t)();
+
+void deadline_monitor_init(uint32_t watchdog_timeout_ms);
+void deadline_monitor_register(uint8_t task_id, const char *name, uint32_t period_ms, uint32_t deadline_ms,
+                               uint32_t wcet_us, bool is_critical);
+void deadline_monitor_set_exec_clock(deadline_exec_clock_t clock);
+void deadline_job_begin(uint8_t task_id);
+void deadline_job_end(uint8_t task_id);
+deadline_action_t deadline_monitor_check();
+bool deadline_monitor_get_stats(uint8_t task_id, deadline_task_stats_t *stats);
+uint8_t deadline_monitor_get_misses(deadline_miss_t *misses, uint8_t max_count);
+void deadline_monitor_report();
+
+#endif // DEADLINE_MONITOR_H
@@ -0,0 +1,177 @@
+#include "power.h"
+#include "hardware/clocks.h"
+
+// Do port RP2040 do FreeRTOS: recarrega o SysTick com clock_get_hz(clk_sys) / configTICK_RATE_HZ
+// e recalcula as constantes do tickless idle.
+void vPortSetupTimerInterrupt(void);
+
+volatile uint8_t power_tickless_enabled = 0;
+
+static power_clock_observer_t observers[POWER_MAX_OBSERVERS];
+static uint8_t observer_count = 0;
+
+static power_profile_t profile = POWER_PROFILE_NORMAL;
+static uint32_t switches = 0;
+static uint32_t last_switch_us = 0;
+
+// Envios em curso que seguram o clock e troca adiada até o último deles terminar
+static uint8_t hold_count = 0;
+static bool is_switch_pending = false;
+static power_profile_t pending_profile;
+
+// Início da janela de medição da fração ociosa
+static uint32_t window_start_us = 0;
+static uint32_t window_start_idle = 0;
+static TickType_t window_start_tick = 0;
+
+static const uint32_t profile_khz[POWER_PROFILE_COUNT] = {POWER_NORMAL_CLOCK_KHZ, POWER_NIGHT_CLOCK_KHZ};
+
+static void restart_window()
+{
+    window_start_us = time_us_32();
+    window_start_idle = ulTaskGetIdleRunTimeCounter();
+    window_start_tick = xTaskGetTickCount();
+}
+
+// Coloca o sistema no perfil normal; deve ser chamada antes da inicialização dos periféricos.
+void power_init()
+{
+    set_sys_clock_khz(POWER_NORMAL_CLOCK_KHZ, true);
+    profile = POWER_PROFILE_NORMAL;
+    power_tickless_enabled = 0;
+}
+
+// Registra um observador chamado a cada troca de clk_sys.
+bool power_register_clock_observer(power_clock_observer_t observer)
+{
+    if (observer_count >= POWER_MAX_OBSERVERS)
+        return false;
+
+    observers[observer_count++] = observer;
+    return true;
+}
+
+static void notify_observers(uint32_t sys_hz)
+{
+    for (uint8_t i = 0; i < observer_count; i++)
+        observers[i](sys_hz);
+}
+
+// Executa a troca; chamada com o escalonador suspenso, para que nenhuma outra tarefa execute com
+// divisores de um clock e o clk_sys de outro.
+static void switch_profile(power_profile_t next)
+{
+    if (next == profile)
+        return;
+
+    uint32_t start_us = time_us_32();
+    uint32_t next_hz = profile_khz[next] * 1000;
+    bool is_speeding_up = next_hz > clock_get_hz(clk_sys);
+
+    // Divisores calculados para o clock mais alto são mais lentos no mais baixo: os
+    // periféricos nunca ficam acima da taxa nominal durante a troca.
+    if (is_speeding_up)
+        notify_observers(next_hz);
+    set_sys_clock_khz(profile_khz[next], true);
+    // O SysTick conta ciclos de clk_sys: sem recarga, o tick passaria a 2,6 ms ou 0,38 ms.
+    // A fração do tick em curso é descartada (menos de 1 ms por troca).
+    vPortSetupTimerInterrupt();
+    if (!is_speeding_up)
+        notify_observers(next_hz);
+
+    profile = next;
+    power_tickless_enabled = next == POWER_PROFILE_NIGHT;
+    switches++;
+    last_switch_us = time_us_32() - start_us;
+    restart_window();
+}
+
+// Troca o perfil de energia e recalcula as configurações dependentes do clock. Com um envio
+// segurando o clock (power_hold), a troca é adiada até power_release e a função retorna logo.
+void power_set_profile(power_profile_t next)
+{
+    if (next >= POWER_PROFILE_COUNT)
+        return;
+
+    vTaskSuspendAll();
+    if (hold_count)
+    {
+        pending_profile = next;
+        is_switch_pending = true;
+    }
+    else
+        switch_profile(next);
+    xTaskResumeAll();
+}
+
+// Segura o clock durante um envio que não pode mudar de taxa no meio (ex.: uma transação I2C,
+// cujos divisores só podem ser trocados com o controlador desligado).
+void power_hold()
+{
+    vTaskSuspendAll();
+    hold_count++;
+    xTaskResumeAll();
+}
+
+// Libera o clock; o último envio a terminar executa a troca pedida enquanto ele estava seguro.
+void power_release()
+{
+    vTaskSuspendAll();
+    if (--hold_count == 0 && is_switch_pending)
+    {
+        is_switch_pending = false;
+        switch_profile(pending_profile);
+    }
+    xTaskResumeAll();
+}
+
+power_profile_t power_get_profile()
+{
+    return profile;
+}
+
+// Mede a fração ociosa desde a última amostra (ou troca) e estima a corrente média.
+void power_sample(power_stats_t *stats)
+{
+    uint32_t now_us = time_us_32();
+    uint32_t idle = ulTaskGetIdleRunTimeCounter();
+    TickType_t tick = xTaskGetTickCount();
+    uint32_t window_us = now_us - window_start_us;
+    uint32_t ticks = tick - window_start_tick;
+    uint32_t idle_us = idle - window_start_idle;
+    uint32_t idle_permille = window_us ? (uint32_t)((uint64_t)idle_us * 1000 / window_us) : 0;
+    if (idle_permille > 1000)
+        idle_permille = 1000;
+
+    uint32_t mhz = clock_get_hz(clk_sys) / 1000000;
+    *stats = (power_stats_t){
+        .profile = profile,
+        .sys_hz = clock_get_hz(clk_sys),
+        .switches = switches,
+        .last_switch_us = last_switch_us,
+        .window_ms = window_us / 1000,
+        .idle_permille = idle_permille,
+        .tick_period_ns = ticks ? (uint32_t)((uint64_t)window_us * 1000 / ticks) : 0,
+        .estimated_ua = POWER_STATIC_UA + mhz * ((1000 - idle_permille) * POWER_ACTIVE_UA_PER_MHZ +
+                                                 idle_permille * POWER_SLEEP_UA_PER_MHZ) / 1000,
+    };
+
+    window_start_us = now_us;
+    window_start_idle = idle;
+    window_start_tick = tick;
+}
+
+// Imprime o perfil atual, o período de tick medido, a fração ociosa e a corrente estimada.
+void power_report()
+{
+    static const char *profile_names[] = {"normal", "noturno"};
+    power_stats_t stats;
+    power_sample(&stats);
+    printf("perfil;clk_mhz;trocas;troca_us;janela_ms;tick_us;ocioso_pct;corrente_ma_est\n");
+    printf("%s;%lu;%lu;%lu;%lu;%lu.%03lu;%u.%u;%lu.%lu\n", profile_names[stats.profile],
+           (unsigned long)(stats.sys_hz / 1000000), (unsigned long)stats.switches,
+           (unsigned long)stats.last_switch_us, (unsigned long)stats.window_ms,
+           (unsigned long)(stats.tick_period_ns / 1000), (unsigned long)(stats.tick_period_ns % 1000),
+           stats.idle_permille / 10, stats.idle_permille % 10, (unsigned long)(stats.estimated_ua / 1000),
+           (unsigned long)(stats.estimated_ua % 1000 / 100));
+}
@@ -0,0 +1,53 @@
+#ifndef POWER_H
+#define POWER_H
+
+#include <stdlib.h>
+#include "pico/stdlib.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define POWER_NORMAL_CLOCK_KHZ 125000 // clk_sys no perfil normal
+#define POWER_NIGHT_CLOCK_KHZ 48000   // clk_sys no perfil noturno (divisor inteiro para a PIO a 800 kHz)
+#define POWER_MAX_OBSERVERS 6         // Observadores de troca de clock
+
+// Modelo de corrente do RP2040 (estimativa a partir do datasheet, sem periféricos externos).
+#define POWER_STATIC_UA 1000         // Corrente independente do clock
+#define POWER_ACTIVE_UA_PER_MHZ 180  // Núcleo executando
+#define POWER_SLEEP_UA_PER_MHZ 60    // Núcleo em WFI com os clocks ativos
+
+typedef enum
+{
+    POWER_PROFILE_NORMAL, // Clock máximo, tick periódico
+    POWER_PROFILE_NIGHT,  // Clock reduzido e tickless idle
+    POWER_PROFILE_COUNT,
+} power_profile_t;
+
+// Chamado com o novo clk_sys para recalcular divisores e taxas que dependem dele.
+typedef void (*power_clock_observer_t)(uint32_t sys_hz);
+
+typedef struct power_stats_t
+{
+    power_profile_t profile;
+    uint32_t sys_hz;          // clk_sys atual
+    uint32_t switches;        // Trocas de perfil
+    uint32_t last_switch_us;  // Duração da última troca (PLL + observadores)
+    uint32_t window_ms;       // Janela de medição desde a última troca ou amostra
+    uint16_t idle_permille;   // Fração do tempo na tarefa ociosa (por mil)
+    uint32_t tick_period_ns;  // Período de tick medido contra o timer de 1 MHz (1000000 esperado)
+    uint32_t estimated_ua;    // Corrente estimada pelo modelo
+} power_stats_t;
+
+// Lido pela macro configPRE_SUPPRESS_TICKS_AND_SLEEP_PROCESSING do FreeRTOSConfig.h.
+extern volatile uint8_t power_tickless_enabled;
+
+void power_init();
+bool power_register_clock_observer(power_clock_observer_t observer);
+void power_set_profile(power_profile_t profile);
+void power_hold();
+void power_release();
+power_profile_t power_get_profile();
+void power_sample(power_stats_t *stats);
+void power_report();
+
+#endif // POWER_H
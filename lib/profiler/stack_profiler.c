@@ -0,0 +1,63 @@
+#include "stack_profiler.h"
+
+typedef struct profiled_task_t
+{
+    TaskHandle_t handle;
+    const char *setting;               // Constante do tamanho em src/task_config.h
+    configSTACK_DEPTH_TYPE stack_size; // Tamanho alocado (em palavras)
+    configSTACK_DEPTH_TYPE min_free;   // Menor folga observada desde o início (em palavras)
+} profiled_task_t;
+
+static profiled_task_t tasks[STACK_PROFILER_MAX_TASKS];
+static uint8_t task_count = 0;
+
+// Registra uma tarefa criada para acompanhar a marca d'água da sua pilha.
+void stack_profiler_register(TaskHandle_t handle, configSTACK_DEPTH_TYPE stack_size, const char *setting)
+{
+    if (handle == NULL || task_count >= STACK_PROFILER_MAX_TASKS)
+        return;
+
+    tasks[task_count++] = (profiled_task_t){
+        .handle = handle,
+        .setting = setting,
+        .stack_size = stack_size,
+        .min_free = stack_size,
+    };
+}
+
+// Lê a marca d'água das pilhas pintadas e guarda a menor folga de cada tarefa.
+void stack_profiler_sample()
+{
+    for (uint8_t i = 0; i < task_count; i++)
+    {
+        configSTACK_DEPTH_TYPE free_words = uxTaskGetStackHighWaterMark(tasks[i].handle);
+        if (free_words < tasks[i].min_free)
+            tasks[i].min_free = free_words;
+    }
+}
+
+// Calcula o tamanho recomendado: pico medido mais a margem, arredondado para cima.
+configSTACK_DEPTH_TYPE stack_profiler_recommended_size(configSTACK_DEPTH_TYPE peak_usage)
+{
+    configSTACK_DEPTH_TYPE with_margin = peak_usage + (peak_usage * STACK_PROFILER_MARGIN_PERCENT + 99) / 100;
+    return (with_margin + STACK_PROFILER_ALIGN_WORDS - 1) / STACK_PROFILER_ALIGN_WORDS * STACK_PROFILER_ALIGN_WORDS;
+}
+
+// Imprime o uso máximo de pilha de cada tarefa e o tamanho recomendado, seguido das definições
+// prontas para substituir as estimativas em src/task_config.h.
+void stack_profiler_report()
+{
+    printf("tarefa;alocado_palavras;pico_palavras;recomendado_palavras\n");
+    for (uint8_t i = 0; i < task_count; i++)
+    {
+        configSTACK_DEPTH_TYPE peak = tasks[i].stack_size - tasks[i].min_free;
+        printf("%s;%lu;%lu;%lu\n", pcTaskGetName(tasks[i].handle), (unsigned long)tasks[i].stack_size,
+               (unsigned long)peak, (unsigned long)stack_profiler_recommended_size(peak));
+    }
+    for (uint8_t i = 0; i < task_count; i++)
+    {
+        configSTACK_DEPTH_TYPE peak = tasks[i].stack_size - tasks[i].min_free;
+        printf("#define %s %lu // Medido: pico de %lu palavras\n", tasks[i].setting,
+               (unsigned long)stack_profiler_recommended_size(peak), (unsigned long)peak);
+    }
+}
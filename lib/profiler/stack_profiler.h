@@ -0,0 +1,19 @@
+#ifndef STACK_PROFILER_H
+#define STACK_PROFILER_H
+
+#include <stdlib.h>
+#include "pico/stdlib.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define STACK_PROFILER_MAX_TASKS 12     // Número máximo de tarefas perfiladas
+#define STACK_PROFILER_MARGIN_PERCENT 25 // Margem de segurança sobre o pico medido
+#define STACK_PROFILER_ALIGN_WORDS 32    // Granularidade do tamanho recomendado (em palavras)
+
+void stack_profiler_register(TaskHandle_t handle, configSTACK_DEPTH_TYPE stack_size, const char *setting);
+void stack_profiler_sample();
+configSTACK_DEPTH_TYPE stack_profiler_recommended_size(configSTACK_DEPTH_TYPE peak_usage);
+void stack_profiler_report();
+
+#endif // STACK_PROFILER_H
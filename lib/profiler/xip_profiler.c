@@ -0,0 +1,119 @@
+#include "xip_profiler.h"
+#include "hardware/structs/xip_ctrl.h"
+#include "hardware/sync.h"
+
+static xip_phase_stats_t phases[XIP_PROFILER_MAX_PHASES];
+static uint8_t phase_count = 0;
+
+// Totais desde o boot: os contadores de 32 bits podem dar a volta em ~30 s executando da flash,
+// por isso são acumulados a cada amostragem periódica.
+static uint64_t total_hits = 0;
+static uint64_t total_accesses = 0;
+static uint32_t last_hits = 0;
+static uint32_t last_accesses = 0;
+static uint64_t report_hits = 0;     // Totais no relatório anterior
+static uint64_t report_accesses = 0;
+
+// Guarda a leitura inicial dos contadores (a escrita os zeraria, por isso são apenas lidos).
+void xip_profiler_init()
+{
+    last_hits = xip_ctrl_hw->ctr_hit;
+    last_accesses = xip_ctrl_hw->ctr_acc;
+}
+
+// Registra um trecho perfilado; retorna seu identificador ou -1 se não houver espaço.
+int xip_profiler_register(const char *name)
+{
+    if (phase_count >= XIP_PROFILER_MAX_PHASES)
+        return -1;
+
+    phases[phase_count] = (xip_phase_stats_t){.name = name};
+    return phase_count++;
+}
+
+void HOT_FUNC(xip_profiler_begin)(xip_sample_t *sample)
+{
+    sample->time_us = time_us_32();
+    sample->hits = xip_ctrl_hw->ctr_hit;
+    sample->accesses = xip_ctrl_hw->ctr_acc;
+}
+
+// Contabiliza os acessos desde o início do trecho. Os contadores são globais: interrupções e o
+// outro núcleo durante o trecho entram na conta, o que também é o custo real observado.
+void HOT_FUNC(xip_profiler_end)(int phase_id, const xip_sample_t *sample)
+{
+    uint32_t accesses = xip_ctrl_hw->ctr_acc - sample->accesses;
+    uint32_t hits = xip_ctrl_hw->ctr_hit - sample->hits;
+    uint32_t elapsed_us = time_us_32() - sample->time_us;
+    if (phase_id < 0 || phase_id >= phase_count)
+        return;
+
+    uint32_t misses = accesses - hits;
+    uint32_t irq_state = save_and_disable_interrupts();
+    xip_phase_stats_t *phase = &phases[phase_id];
+    phase->runs++;
+    phase->accesses += accesses;
+    phase->hits += hits;
+    if (misses > phase->max_misses)
+        phase->max_misses = misses;
+    if (elapsed_us > phase->max_us)
+        phase->max_us = elapsed_us;
+    restore_interrupts(irq_state);
+}
+
+// Acumula os contadores globais; deve ser chamada com período bem menor que a volta dos contadores.
+void xip_profiler_sample()
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+    uint32_t hits = xip_ctrl_hw->ctr_hit;
+    uint32_t accesses = xip_ctrl_hw->ctr_acc;
+    total_hits += hits - last_hits;
+    total_accesses += accesses - last_accesses;
+    last_hits = hits;
+    last_accesses = accesses;
+    restore_interrupts(irq_state);
+}
+
+bool xip_profiler_get_stats(int phase_id, xip_phase_stats_t *out)
+{
+    if (phase_id < 0 || phase_id >= phase_count)
+        return false;
+
+    uint32_t irq_state = save_and_disable_interrupts();
+    *out = phases[phase_id];
+    restore_interrupts(irq_state);
+    return true;
+}
+
+// Taxa de acerto em décimos de por cento (100,0% sem acessos).
+static uint32_t hit_rate_permille(uint64_t hits, uint64_t accesses)
+{
+    return accesses ? (uint32_t)(hits * 1000 / accesses) : 1000;
+}
+
+// Imprime a taxa de acerto global no intervalo e, por trecho, os acessos, as faltas e o pior caso.
+void xip_profiler_report()
+{
+    xip_profiler_sample();
+    uint64_t hits = total_hits - report_hits;
+    uint64_t accesses = total_accesses - report_accesses;
+    report_hits = total_hits;
+    report_accesses = total_accesses;
+
+    uint32_t rate = hit_rate_permille(hits, accesses);
+    printf("xip;acessos;%llu;faltas;%llu;acerto;%lu.%lu%%\n", (unsigned long long)accesses,
+           (unsigned long long)(accesses - hits), (unsigned long)(rate / 10), (unsigned long)(rate % 10));
+
+    printf("trecho;execucoes;acessos_medios;faltas_medias;faltas_max;acerto;duracao_max_us\n");
+    for (int id = 0; id < phase_count; id++)
+    {
+        xip_phase_stats_t phase;
+        xip_profiler_get_stats(id, &phase);
+        uint32_t runs = phase.runs ? phase.runs : 1;
+        rate = hit_rate_permille(phase.hits, phase.accesses);
+        printf("%s;%lu;%lu;%lu;%lu;%lu.%lu%%;%lu\n", phase.name, (unsigned long)phase.runs,
+               (unsigned long)(phase.accesses / runs), (unsigned long)((phase.accesses - phase.hits) / runs),
+               (unsigned long)phase.max_misses, (unsigned long)(rate / 10), (unsigned long)(rate % 10),
+               (unsigned long)phase.max_us);
+    }
+}
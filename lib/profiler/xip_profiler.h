@@ -0,0 +1,45 @@
+#ifndef XIP_PROFILER_H
+#define XIP_PROFILER_H
+
+#include <stdlib.h>
+#include "pico/stdlib.h"
+
+#define XIP_PROFILER_MAX_PHASES 8 // Número máximo de trechos perfilados
+
+// Com -DRAM_HOT_PATHS=ON, as funções e tabelas marcadas são copiadas para a SRAM no boot e deixam
+// de passar pela cache XIP. Sem a opção, permanecem na flash: os dois builds são comparados pelo relatório.
+#ifdef RAM_HOT_PATHS
+#define HOT_FUNC(name) __not_in_flash_func(name)
+#define HOT_DATA __not_in_flash("hot")
+#else
+#define HOT_FUNC(name) name
+#define HOT_DATA
+#endif
+
+// Leitura dos contadores da cache XIP no início de um trecho.
+typedef struct xip_sample_t
+{
+    uint32_t hits;     // ctr_hit
+    uint32_t accesses; // ctr_acc
+    uint32_t time_us;
+} xip_sample_t;
+
+typedef struct xip_phase_stats_t
+{
+    const char *name;    // Nome do trecho
+    uint32_t runs;       // Execuções medidas
+    uint64_t accesses;   // Acessos à cache XIP durante o trecho
+    uint64_t hits;       // Acertos
+    uint32_t max_misses; // Maior número de faltas em uma execução
+    uint32_t max_us;     // Maior duração de uma execução
+} xip_phase_stats_t;
+
+void xip_profiler_init();
+int xip_profiler_register(const char *name);
+void xip_profiler_begin(xip_sample_t *sample);
+void xip_profiler_end(int phase_id, const xip_sample_t *sample);
+void xip_profiler_sample();
+bool xip_profiler_get_stats(int phase_id, xip_phase_stats_t *stats);
+void xip_profiler_report();
+
+#endif // XIP_PROFILER_H
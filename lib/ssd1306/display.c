@@ -3,7 +3,7 @@
 void init_display(ssd1306_t *ssd)
 {
     // I2C Initialisation. Using it at 400Khz.
-    i2c_init(SSD1306_I2C_PORT, 400 * 1000);
+    i2c_init(SSD1306_I2C_PORT, SSD1306_I2C_BAUDRATE);
 
     gpio_set_function(SSD1306_I2C_SDA, GPIO_FUNC_I2C);                          // Set the GPIO pin function to I2C
     gpio_set_function(SSD1306_I2C_SCL, GPIO_FUNC_I2C);                          // Set the GPIO pin function to I2C
@@ -25,4 +25,23 @@ void draw_centered_text(ssd1306_t *ssd, const char *text, int y)
 {
     int x = (128 - (strlen(text) * 8)) / 2; // Calcula a posição X para centralizar
     ssd1306_draw_string(ssd, text, x, y);   // Desenha o texto na posição calculada
-}
\ No newline at end of file
+}
+static volatile bool is_clock_changed = false;
+
+// Observador de troca de clock: só marca o divisor do I2C como desatualizado. Trocar o divisor
+// exige desligar o controlador, o que abortaria um envio em curso; quem envia o reprograma.
+void display_set_clock(uint32_t sys_hz)
+{
+    is_clock_changed = true;
+}
+
+// Reprograma o divisor do I2C após uma troca de clock. Chamada pela tarefa dona do barramento
+// antes de cada envio, com o clock seguro (power_hold): clock_get_hz já devolve o clk_sys atual.
+void display_apply_clock()
+{
+    if (!is_clock_changed)
+        return;
+
+    is_clock_changed = false;
+    i2c_set_baudrate(SSD1306_I2C_PORT, SSD1306_I2C_BAUDRATE);
+}
@@ -10,8 +10,19 @@
 #define SSD1306_I2C_SDA 14
 #define SSD1306_I2C_SCL 15
 #define SSD1306_ADDRESS 0x3C
+#define SSD1306_I2C_BAUDRATE (400 * 1000)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 void init_display(ssd1306_t *ssd);
 void draw_centered_text(ssd1306_t *ssd, const char *text, int y);
+void display_set_clock(uint32_t sys_hz);
+void display_apply_clock();
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif // SSD1306_DISPLAY_H
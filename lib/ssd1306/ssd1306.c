@@ -1,5 +1,6 @@
 #include "ssd1306.h"
 #include "font.h"
+#include "profiler/xip_profiler.h"
 
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
   ssd->width = width;
@@ -10,6 +11,8 @@ void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_v
   ssd->bufsize = ssd->pages * ssd->width + 1;
   ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
   ssd->ram_buffer[0] = 0x40;
+  ssd->region_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
+  ssd->region_buffer[0] = 0x40;
   ssd->port_buffer[0] = 0x80;
 }
 
@@ -68,7 +71,33 @@ void ssd1306_send_data(ssd1306_t *ssd) {
   );
 }
 
-void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
+// Envia apenas as colunas x0..x1 das páginas page0..page1 (8 linhas por página).
+void ssd1306_send_region(ssd1306_t *ssd, uint8_t x0, uint8_t page0, uint8_t x1, uint8_t page1) {
+  ssd1306_command(ssd, SET_COL_ADDR);
+  ssd1306_command(ssd, x0);
+  ssd1306_command(ssd, x1);
+  ssd1306_command(ssd, SET_PAGE_ADDR);
+  ssd1306_command(ssd, page0);
+  ssd1306_command(ssd, page1);
+
+  // No modo vertical o display avança a página antes da coluna: junta os bytes nessa ordem.
+  size_t length = 1;
+  for (uint x = x0; x <= x1; ++x) {
+    const uint8_t *column = &ssd->ram_buffer[x * ssd->pages + 1];
+    for (uint page = page0; page <= page1; ++page)
+      ssd->region_buffer[length++] = column[page];
+  }
+
+  i2c_write_blocking(
+    ssd->i2c_port,
+    ssd->address,
+    ssd->region_buffer,
+    length,
+    false
+  );
+}
+
+void HOT_FUNC(ssd1306_pixel)(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
   uint16_t index = (y >> 3) + (x << 3) + 1;
   uint8_t pixel = (y & 0b111);
   if (value)
@@ -84,7 +113,7 @@ void ssd1306_fill(ssd1306_t *ssd, bool value) {
     ssd->ram_buffer[i] = byte;
 }*/
 
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
+void HOT_FUNC(ssd1306_fill)(ssd1306_t *ssd, bool value) {
     // Itera por todas as posições do display
     for (uint8_t y = 0; y < ssd->height; ++y) {
         for (uint8_t x = 0; x < ssd->width; ++x) {
@@ -95,7 +124,7 @@ void ssd1306_fill(ssd1306_t *ssd, bool value) {
 
 
 
-void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
+void HOT_FUNC(ssd1306_rect)(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
   for (uint8_t x = left; x < left + width; ++x) {
     ssd1306_pixel(ssd, x, top, value);
     ssd1306_pixel(ssd, x, top + height - 1, value);
@@ -114,7 +143,7 @@ void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint
   }
 }
 
-void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value) {
+void HOT_FUNC(ssd1306_line)(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value) {
     int dx = abs(x1 - x0);
     int dy = abs(y1 - y0);
 
@@ -143,18 +172,26 @@ void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1
 }
 
 
-void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value) {
+void HOT_FUNC(ssd1306_hline)(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value) {
   for (uint8_t x = x0; x <= x1; ++x)
     ssd1306_pixel(ssd, x, y, value);
 }
 
-void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
+void HOT_FUNC(ssd1306_vline)(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
   for (uint8_t y = y0; y <= y1; ++y)
     ssd1306_pixel(ssd, x, y, value);
 }
 
+// Retorna as 8 colunas do glifo de um caractere (bit 0 = linha de cima).
+const uint8_t *HOT_FUNC(ssd1306_glyph)(char c)
+{
+  if (c < ' ' || c > '~')
+    c = ' ';
+  return &font[(c - ' ') * 8];
+}
+
 // Função para desenhar um caractere
-void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
+void HOT_FUNC(ssd1306_draw_char)(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
 {
   uint16_t index = 0;
 
@@ -181,7 +218,7 @@ void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
 }
 
 // Função para desenhar uma string
-void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
+void HOT_FUNC(ssd1306_draw_string)(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
 {
   while (*str)
   {
@@ -34,13 +34,19 @@ typedef struct {
   bool external_vcc;
   uint8_t *ram_buffer;
   size_t bufsize;
+  uint8_t *region_buffer; // Dados de uma região, na ordem de envio do modo vertical
   uint8_t port_buffer[2];
 } ssd1306_t;
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
 void ssd1306_config(ssd1306_t *ssd);
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
 void ssd1306_send_data(ssd1306_t *ssd);
+void ssd1306_send_region(ssd1306_t *ssd, uint8_t x0, uint8_t page0, uint8_t x1, uint8_t page1);
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
 void ssd1306_fill(ssd1306_t *ssd, bool value);
@@ -50,5 +56,10 @@ void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value);
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y);
 void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
+const uint8_t *ssd1306_glyph(char c);
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif // SSD1306_H
@@ -0,0 +1,307 @@
+#include <stdio.h>
+#include <string.h>
+#include "ui.h"
+
+static bool rect_is_empty(ui_rect_t r)
+{
+    return r.width == 0 || r.height == 0;
+}
+
+static ui_rect_t rect_intersect(ui_rect_t a, ui_rect_t b)
+{
+    int x0 = MAX(a.x, b.x), y0 = MAX(a.y, b.y);
+    int x1 = MIN(a.x + a.width, b.x + b.width), y1 = MIN(a.y + a.height, b.y + b.height);
+    if (x1 <= x0 || y1 <= y0)
+        return (ui_rect_t){0};
+    return (ui_rect_t){x0, y0, x1 - x0, y1 - y0};
+}
+
+static ui_rect_t rect_union(ui_rect_t a, ui_rect_t b)
+{
+    int x0 = MIN(a.x, b.x), y0 = MIN(a.y, b.y);
+    int x1 = MAX(a.x + a.width, b.x + b.width), y1 = MAX(a.y + a.height, b.y + b.height);
+    return (ui_rect_t){x0, y0, x1 - x0, y1 - y0};
+}
+
+// Regiões que se tocam ou se sobrepõem são unidas.
+static bool rect_touches(ui_rect_t a, ui_rect_t b)
+{
+    return a.x <= b.x + b.width && b.x <= a.x + a.width && a.y <= b.y + b.height && b.y <= a.y + a.height;
+}
+
+// Acrescenta uma região a uma lista, unindo-a a outra que ela toque ou, se a lista estiver cheia, à última.
+static void rect_list_add(ui_rect_t *list, uint8_t *count, ui_rect_t area)
+{
+    for (uint8_t i = 0; i < *count; i++)
+    {
+        if (rect_touches(list[i], area))
+        {
+            list[i] = rect_union(list[i], area);
+            return;
+        }
+    }
+
+    if (*count < UI_MAX_DIRTY)
+        list[(*count)++] = area;
+    else
+        list[UI_MAX_DIRTY - 1] = rect_union(list[UI_MAX_DIRTY - 1], area);
+}
+
+void ui_screen_init(ui_screen_t *screen, ssd1306_t *ssd)
+{
+    *screen = (ui_screen_t){.ssd = ssd};
+}
+
+// Acrescenta um widget à tela (por cima dos anteriores) e invalida seus limites.
+bool ui_add(ui_screen_t *screen, ui_widget_t *widget)
+{
+    if (screen->widget_count >= UI_MAX_WIDGETS)
+        return false;
+
+    screen->widgets[screen->widget_count++] = widget;
+    ui_invalidate(screen, widget->bounds);
+    return true;
+}
+
+// Marca uma área para ser redesenhada no próximo ui_render.
+void ui_invalidate(ui_screen_t *screen, ui_rect_t area)
+{
+    area = rect_intersect(area, (ui_rect_t){0, 0, screen->ssd->width, screen->ssd->height});
+    if (!rect_is_empty(area))
+        rect_list_add(screen->dirty, &screen->dirty_count, area);
+}
+
+void ui_invalidate_all(ui_screen_t *screen)
+{
+    ui_invalidate(screen, (ui_rect_t){0, 0, screen->ssd->width, screen->ssd->height});
+}
+
+void ui_label_init(ui_widget_t *widget, ui_rect_t bounds, const char *text, bool centered)
+{
+    *widget = (ui_widget_t){.type = UI_LABEL, .bounds = bounds, .visible = true};
+    strncpy(widget->label.text, text, UI_LABEL_MAX);
+    widget->label.centered = centered;
+}
+
+void ui_frame_init(ui_widget_t *widget, ui_rect_t bounds, bool fill)
+{
+    *widget = (ui_widget_t){.type = UI_FRAME, .bounds = bounds, .visible = true};
+    widget->frame.fill = fill;
+}
+
+void ui_bar_init(ui_widget_t *widget, ui_rect_t bounds, uint16_t value, uint16_t max)
+{
+    *widget = (ui_widget_t){.type = UI_BAR, .bounds = bounds, .visible = true};
+    widget->bar.value = value;
+    widget->bar.max = max;
+}
+
+void ui_icon_init(ui_widget_t *widget, ui_rect_t bounds, const uint8_t *columns)
+{
+    *widget = (ui_widget_t){.type = UI_ICON, .bounds = bounds, .visible = true};
+    widget->icon.columns = columns;
+}
+
+// Altera o texto de um rótulo; só invalida se o texto mudou.
+void ui_label_set_text(ui_screen_t *screen, ui_widget_t *widget, const char *text)
+{
+    if (strncmp(widget->label.text, text, UI_LABEL_MAX) == 0)
+        return;
+
+    strncpy(widget->label.text, text, UI_LABEL_MAX);
+    ui_invalidate(screen, widget->bounds);
+}
+
+void ui_bar_set_value(ui_screen_t *screen, ui_widget_t *widget, uint16_t value)
+{
+    if (widget->bar.value == value)
+        return;
+
+    widget->bar.value = value;
+    ui_invalidate(screen, widget->bounds);
+}
+
+void ui_icon_set(ui_screen_t *screen, ui_widget_t *widget, const uint8_t *columns)
+{
+    if (widget->icon.columns == columns)
+        return;
+
+    widget->icon.columns = columns;
+    ui_invalidate(screen, widget->bounds);
+}
+
+void ui_set_visible(ui_screen_t *screen, ui_widget_t *widget, bool visible)
+{
+    if (widget->visible == visible)
+        return;
+
+    widget->visible = visible;
+    ui_invalidate(screen, widget->bounds);
+}
+
+// Desenha um pixel apenas dentro da região de recorte.
+static inline void clipped_pixel(const ui_rect_t *clip, ssd1306_t *ssd, int x, int y, bool value)
+{
+    if (x < clip->x || y < clip->y || x >= clip->x + clip->width || y >= clip->y + clip->height)
+        return;
+    ssd1306_pixel(ssd, x, y, value);
+}
+
+static void draw_label(ui_screen_t *screen, const ui_widget_t *widget, const ui_rect_t *clip)
+{
+    int length = strlen(widget->label.text);
+    int x = widget->bounds.x;
+    if (widget->label.centered && length * UI_CHAR_WIDTH < widget->bounds.width)
+        x += (widget->bounds.width - length * UI_CHAR_WIDTH) / 2;
+
+    for (int c = 0; c < length; c++, x += UI_CHAR_WIDTH)
+    {
+        if (x >= clip->x + clip->width || x + UI_CHAR_WIDTH <= clip->x)
+            continue;
+
+        const uint8_t *glyph = ssd1306_glyph(widget->label.text[c]);
+        for (int i = 0; i < UI_CHAR_WIDTH; i++)
+            for (int j = 0; j < 8; j++)
+                clipped_pixel(clip, screen->ssd, x + i, widget->bounds.y + j, glyph[i] & (1 << j));
+    }
+}
+
+static void draw_frame(ui_screen_t *screen, const ui_widget_t *widget, const ui_rect_t *clip)
+{
+    const ui_rect_t *b = &widget->bounds;
+    for (int y = clip->y; y < clip->y + clip->height; y++)
+    {
+        for (int x = clip->x; x < clip->x + clip->width; x++)
+        {
+            bool is_edge = x == b->x || y == b->y || x == b->x + b->width - 1 || y == b->y + b->height - 1;
+            if (widget->frame.fill || is_edge)
+                ssd1306_pixel(screen->ssd, x, y, true);
+        }
+    }
+}
+
+static void draw_bar(ui_screen_t *screen, const ui_widget_t *widget, const ui_rect_t *clip)
+{
+    const ui_rect_t *b = &widget->bounds;
+    uint16_t value = MIN(widget->bar.value, widget->bar.max);
+    int filled = widget->bar.max ? (b->width - 2) * value / widget->bar.max : 0;
+    for (int y = clip->y; y < clip->y + clip->height; y++)
+    {
+        for (int x = clip->x; x < clip->x + clip->width; x++)
+        {
+            bool is_edge = x == b->x || y == b->y || x == b->x + b->width - 1 || y == b->y + b->height - 1;
+            bool is_filled = x - b->x - 1 < filled;
+            ssd1306_pixel(screen->ssd, x, y, is_edge || is_filled);
+        }
+    }
+}
+
+static void draw_icon(ui_screen_t *screen, const ui_widget_t *widget, const ui_rect_t *clip)
+{
+    const ui_rect_t *b = &widget->bounds;
+    if (!widget->icon.columns)
+        return;
+
+    for (int i = 0; i < b->width; i++)
+        for (int j = 0; j < MIN(b->height, 8); j++)
+            clipped_pixel(clip, screen->ssd, b->x + i, b->y + j, widget->icon.columns[i] & (1 << j));
+}
+
+// Redesenha as regiões inválidas no buffer; retorna false se nada mudou.
+bool ui_render(ui_screen_t *screen)
+{
+    if (screen->dirty_count == 0)
+        return false;
+
+    for (uint8_t d = 0; d < screen->dirty_count; d++)
+    {
+        ui_rect_t area = screen->dirty[d];
+
+        for (int y = area.y; y < area.y + area.height; y++)
+            for (int x = area.x; x < area.x + area.width; x++)
+                ssd1306_pixel(screen->ssd, x, y, false);
+
+        // Cada widget é recortado à interseção com a região: nada fora dela é alterado.
+        for (uint8_t w = 0; w < screen->widget_count; w++)
+        {
+            const ui_widget_t *widget = screen->widgets[w];
+            ui_rect_t clip = rect_intersect(area, widget->bounds);
+            if (!widget->visible || rect_is_empty(clip))
+                continue;
+
+            switch (widget->type)
+            {
+            case UI_LABEL:
+                draw_label(screen, widget, &clip);
+                break;
+            case UI_FRAME:
+                draw_frame(screen, widget, &clip);
+                break;
+            case UI_BAR:
+                draw_bar(screen, widget, &clip);
+                break;
+            case UI_ICON:
+                draw_icon(screen, widget, &clip);
+                break;
+            }
+        }
+
+        // O display é escrito em páginas de 8 linhas: a região enviada é alinhada a elas.
+        uint8_t page0 = area.y / 8, page1 = (area.y + area.height - 1) / 8;
+        ui_rect_t band = {area.x, page0 * 8, area.width, (page1 - page0 + 1) * 8};
+        rect_list_add(screen->flush, &screen->flush_count, band);
+    }
+    screen->dirty_count = 0;
+    return true;
+}
+
+// Envia ao display apenas as regiões redesenhadas desde o último envio.
+void ui_flush(ui_screen_t *screen)
+{
+    for (uint8_t i = 0; i < screen->flush_count; i++)
+    {
+        ui_rect_t area = screen->flush[i];
+        ssd1306_send_region(screen->ssd, area.x, area.y / 8, area.x + area.width - 1,
+                            (area.y + area.height - 1) / 8);
+    }
+    screen->flush_count = 0;
+}
+
+// Mede o redesenho e o envio da tela completa e de uma atualização em que só o rótulo informado muda.
+void ui_benchmark(ui_screen_t *screen, ui_widget_t *label)
+{
+    const uint updates = 100;
+    char original[UI_LABEL_MAX + 1];
+    strcpy(original, label->label.text);
+
+    ui_invalidate_all(screen);
+    uint32_t start_us = time_us_32();
+    ui_render(screen);
+    uint32_t full_render_us = time_us_32() - start_us;
+    start_us = time_us_32();
+    ui_flush(screen);
+    uint32_t full_flush_us = time_us_32() - start_us;
+
+    uint32_t render_us = 0, flush_us = 0;
+    for (uint i = 0; i < updates; i++)
+    {
+        char text[UI_LABEL_MAX + 1];
+        snprintf(text, sizeof(text), "%u", i);
+        ui_label_set_text(screen, label, text);
+
+        start_us = time_us_32();
+        ui_render(screen);
+        render_us += time_us_32() - start_us;
+        start_us = time_us_32();
+        ui_flush(screen);
+        flush_us += time_us_32() - start_us;
+    }
+
+    ui_label_set_text(screen, label, original);
+    ui_render(screen);
+    ui_flush(screen);
+
+    printf("ui;render_completo_us;%lu;envio_completo_us;%lu;render_parcial_us;%lu;envio_parcial_us;%lu\n",
+           (unsigned long)full_render_us, (unsigned long)full_flush_us, (unsigned long)(render_us / updates),
+           (unsigned long)(flush_us / updates));
+}
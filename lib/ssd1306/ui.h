@@ -0,0 +1,86 @@
+#ifndef SSD1306_UI_H
+#define SSD1306_UI_H
+
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "ssd1306.h"
+#include "display.h"
+
+#define UI_MAX_WIDGETS 16 // Widgets por tela
+#define UI_MAX_DIRTY 4    // Regiões inválidas mantidas antes de serem unidas
+#define UI_LABEL_MAX 16   // Caracteres por rótulo (128 / 8)
+#define UI_CHAR_WIDTH 8
+
+typedef struct ui_rect_t
+{
+    uint8_t x, y, width, height;
+} ui_rect_t;
+
+typedef enum
+{
+    UI_LABEL, // Texto de uma linha, opcionalmente centralizado nos limites
+    UI_FRAME, // Retângulo (contorno ou preenchido); linhas são molduras de altura 1
+    UI_BAR,   // Barra de progresso horizontal
+    UI_ICON,  // Bitmap em colunas de 8 pixels (bit 0 = linha de cima)
+} ui_widget_type_t;
+
+typedef struct ui_widget_t
+{
+    uint8_t type; // ui_widget_type_t
+    ui_rect_t bounds;
+    bool visible;
+    union
+    {
+        struct
+        {
+            char text[UI_LABEL_MAX + 1];
+            bool centered;
+        } label;
+        struct
+        {
+            bool fill;
+        } frame;
+        struct
+        {
+            uint16_t value, max;
+        } bar;
+        struct
+        {
+            const uint8_t *columns; // bounds.width colunas
+        } icon;
+    };
+} ui_widget_t;
+
+// Tela em modo retido: os widgets guardam seu estado e só as regiões alteradas são redesenhadas e enviadas.
+typedef struct ui_screen_t
+{
+    ssd1306_t *ssd;
+    ui_widget_t *widgets[UI_MAX_WIDGETS]; // Ordem de desenho (o último fica por cima)
+    uint8_t widget_count;
+    ui_rect_t dirty[UI_MAX_DIRTY];        // Regiões a redesenhar
+    uint8_t dirty_count;
+    ui_rect_t flush[UI_MAX_DIRTY];        // Regiões redesenhadas ainda não enviadas
+    uint8_t flush_count;
+    ui_rect_t clip;                       // Região sendo redesenhada
+} ui_screen_t;
+
+void ui_screen_init(ui_screen_t *screen, ssd1306_t *ssd);
+bool ui_add(ui_screen_t *screen, ui_widget_t *widget);
+void ui_invalidate(ui_screen_t *screen, ui_rect_t area);
+void ui_invalidate_all(ui_screen_t *screen);
+
+void ui_label_init(ui_widget_t *widget, ui_rect_t bounds, const char *text, bool centered);
+void ui_frame_init(ui_widget_t *widget, ui_rect_t bounds, bool fill);
+void ui_bar_init(ui_widget_t *widget, ui_rect_t bounds, uint16_t value, uint16_t max);
+void ui_icon_init(ui_widget_t *widget, ui_rect_t bounds, const uint8_t *columns);
+
+void ui_label_set_text(ui_screen_t *screen, ui_widget_t *widget, const char *text);
+void ui_bar_set_value(ui_screen_t *screen, ui_widget_t *widget, uint16_t value);
+void ui_icon_set(ui_screen_t *screen, ui_widget_t *widget, const uint8_t *columns);
+void ui_set_visible(ui_screen_t *screen, ui_widget_t *widget, bool visible);
+
+bool ui_render(ui_screen_t *screen);
+void ui_flush(ui_screen_t *screen);
+void ui_benchmark(ui_screen_t *screen, ui_widget_t *label);
+
+#endif // SSD1306_UI_H
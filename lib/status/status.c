@@ -0,0 +1,316 @@
+#include <stdio.h>
+#include <string.h>
+#include "status.h"
+#include "log/log.h"
+#include "pico/stdio_usb.h"
+
+// Quadro: sincronismo, canal, tamanho, carga útil e CRC-8 da carga útil, como no log.
+// A carga útil começa com a sequência (u16), o tópico (u8) e o instante da codificação (u32).
+#define STATUS_FRAME_OVERHEAD 4
+#define STATUS_PHASE_SIZE 10
+#define STATUS_OUTPUTS_SIZE 6
+#define STATUS_STATS_SIZE 20
+#define STATUS_ECHO_SIZE 4
+
+typedef struct subscription_t
+{
+    bool is_active;
+    bool is_forced;        // Envia o estado atual na próxima chamada, mesmo sem mudança
+    uint32_t interval_ms;  // Menor intervalo entre quadros do tópico
+    uint32_t last_sent_ms;
+} subscription_t;
+
+static const char *const topic_names[STATUS_TOPIC_COUNT] = {
+    [STATUS_TOPIC_PHASE] = "fase",
+    [STATUS_TOPIC_OUTPUTS] = "saidas",
+    [STATUS_TOPIC_STATS] = "estatisticas",
+};
+
+static status_sources_t sources;
+static subscription_t subscriptions[STATUS_TOPIC_COUNT];
+static status_phase_t last_phase;
+static status_outputs_t last_outputs;
+static bool was_connected = false;
+
+// Buffer de transmissão: cada quadro é contíguo. Quando não cabe antes do fim, o quadro começa
+// no início do buffer e wrap marca onde terminam os dados da volta anterior. Assim cada escrita no
+// stdout leva apenas quadros inteiros, e um printf de outra tarefa nunca divide um quadro.
+static uint8_t tx_ring[STATUS_TX_RING_SIZE];
+static uint16_t tx_head = 0;
+static uint16_t tx_tail = 0;
+static uint16_t tx_wrap = STATUS_TX_RING_SIZE;
+static uint8_t tx_crc;
+static uint16_t tx_sequence = 0;
+static status_tx_stats_t tx_stats;
+
+static uint16_t pending_bytes()
+{
+    return tx_head >= tx_tail ? tx_head - tx_tail : tx_wrap - tx_tail + tx_head;
+}
+
+// Reserva espaço contíguo para um quadro; head == tail sempre significa buffer vazio.
+static bool reserve(uint16_t size)
+{
+    if (tx_head == tx_tail)
+        tx_head = tx_tail = 0;
+
+    if (tx_head >= tx_tail)
+    {
+        if (STATUS_TX_RING_SIZE - tx_head >= size)
+            return true;
+        if (tx_tail > size)
+        {
+            tx_wrap = tx_head;
+            tx_head = 0;
+            return true;
+        }
+        return false;
+    }
+    return tx_tail - tx_head > size;
+}
+
+static void put_u8(uint8_t value)
+{
+    tx_ring[tx_head++] = value;
+    tx_crc ^= value;
+    for (uint8_t bit = 0; bit < 8; bit++)
+        tx_crc = (tx_crc & 0x80) ? (uint8_t)((tx_crc << 1) ^ 0x07) : (uint8_t)(tx_crc << 1);
+}
+
+static void put_u16(uint16_t value)
+{
+    put_u8(value);
+    put_u8(value >> 8);
+}
+
+static void put_u32(uint32_t value)
+{
+    put_u16(value);
+    put_u16(value >> 16);
+}
+
+// Abre um quadro direto no buffer de transmissão. A sequência avança mesmo quando o quadro é
+// descartado, para o host contar as perdas pelas lacunas.
+static bool frame_begin(uint8_t topic, uint8_t payload_size)
+{
+    uint16_t sequence = tx_sequence++;
+    uint8_t length = STATUS_HEADER_SIZE + payload_size;
+    if (!reserve(STATUS_FRAME_OVERHEAD + length))
+    {
+        tx_stats.dropped++;
+        return false;
+    }
+
+    tx_ring[tx_head++] = LOG_FRAME_SYNC;
+    tx_ring[tx_head++] = STATUS_FRAME_CHANNEL;
+    tx_ring[tx_head++] = length;
+    tx_crc = 0;
+    put_u16(sequence);
+    put_u8(topic);
+    put_u32(time_us_32());
+    return true;
+}
+
+static void frame_end()
+{
+    tx_ring[tx_head++] = tx_crc;
+    tx_stats.frames++;
+    uint16_t pending = pending_bytes();
+    if (pending > tx_stats.max_pending)
+        tx_stats.max_pending = pending;
+}
+
+static void encode_phase(const status_phase_t *phase)
+{
+    if (!frame_begin(STATUS_TOPIC_PHASE, STATUS_PHASE_SIZE))
+        return;
+    put_u32(phase->sequence);
+    put_u32(phase->boundary_us);
+    put_u8(phase->light_state);
+    put_u8(phase->flags);
+    frame_end();
+}
+
+static void encode_outputs(const status_outputs_t *outputs)
+{
+    if (!frame_begin(STATUS_TOPIC_OUTPUTS, STATUS_OUTPUTS_SIZE))
+        return;
+    put_u8(outputs->leds);
+    put_u8(outputs->matrix_kind);
+    put_u16(outputs->buzzer_hz[0]);
+    put_u16(outputs->buzzer_hz[1]);
+    frame_end();
+}
+
+static void encode_stats(const status_stats_t *stats)
+{
+    if (!frame_begin(STATUS_TOPIC_STATS, STATUS_STATS_SIZE))
+        return;
+    put_u32(stats->uptime_ms);
+    put_u32(stats->misses);
+    put_u32(stats->pedestrian_calls);
+    put_u32(stats->max_latency_ms);
+    put_u32(stats->vehicles);
+    frame_end();
+}
+
+static bool phase_changed(const status_phase_t *phase)
+{
+    return phase->sequence != last_phase.sequence || phase->boundary_us != last_phase.boundary_us ||
+           phase->light_state != last_phase.light_state || phase->flags != last_phase.flags;
+}
+
+static bool outputs_changed(const status_outputs_t *outputs)
+{
+    return outputs->leds != last_outputs.leds || outputs->matrix_kind != last_outputs.matrix_kind ||
+           outputs->buzzer_hz[0] != last_outputs.buzzer_hz[0] || outputs->buzzer_hz[1] != last_outputs.buzzer_hz[1];
+}
+
+// Define as fontes dos instantâneos de cada tópico. Todas as demais funções devem ser chamadas
+// pela mesma tarefa que envia o log, para os quadros não se intercalarem.
+void status_init(const status_sources_t *config)
+{
+    sources = *config;
+    memset(subscriptions, 0, sizeof(subscriptions));
+    tx_head = tx_tail = 0;
+    tx_wrap = STATUS_TX_RING_SIZE;
+    tx_stats = (status_tx_stats_t){0};
+}
+
+// Tópico pelo nome usado nos comandos do host, ou -1.
+int status_topic_from_name(const char *name)
+{
+    for (int topic = 0; topic < STATUS_TOPIC_COUNT; topic++)
+    {
+        if (strcmp(name, topic_names[topic]) == 0)
+            return topic;
+    }
+    return -1;
+}
+
+// Assina um tópico com um intervalo mínimo entre quadros; o estado atual segue na próxima chamada.
+// Com intervalo 0 o tópico sai a cada período da tarefa de envio.
+bool status_subscribe(int topic, uint32_t interval_ms)
+{
+    if (topic < 0 || topic >= STATUS_TOPIC_COUNT)
+        return false;
+
+    subscriptions[topic] = (subscription_t){
+        .is_active = true,
+        .is_forced = true,
+        .interval_ms = interval_ms,
+    };
+    return true;
+}
+
+void status_unsubscribe(int topic)
+{
+    if (topic >= 0 && topic < STATUS_TOPIC_COUNT)
+        subscriptions[topic].is_active = false;
+}
+
+// Devolve o identificador recebido com o instante local, para o host medir o atraso do enlace
+// e alinhar os instantes do firmware ao seu relógio.
+void status_echo(uint32_t token)
+{
+    if (!frame_begin(STATUS_TOPIC_ECHO, STATUS_ECHO_SIZE))
+        return;
+    put_u32(token);
+    frame_end();
+}
+
+// Codifica no buffer de transmissão os tópicos assinados que mudaram ou venceram o intervalo.
+// Sem host conectado as assinaturas são canceladas.
+void status_service()
+{
+    bool is_connected = stdio_usb_connected();
+    if (!is_connected)
+    {
+        if (was_connected)
+            memset(subscriptions, 0, sizeof(subscriptions));
+        tx_tail = tx_head;
+        was_connected = false;
+        return;
+    }
+    was_connected = true;
+
+    uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+    for (int topic = 0; topic < STATUS_TOPIC_COUNT; topic++)
+    {
+        subscription_t *subscription = &subscriptions[topic];
+        if (!subscription->is_active)
+            continue;
+        if (!subscription->is_forced && now_ms - subscription->last_sent_ms < subscription->interval_ms)
+            continue;
+
+        bool is_sent = true;
+        if (topic == STATUS_TOPIC_PHASE)
+        {
+            status_phase_t phase;
+            sources.phase(&phase);
+            is_sent = subscription->is_forced || phase_changed(&phase);
+            if (is_sent)
+                encode_phase(&phase);
+            last_phase = phase;
+        }
+        else if (topic == STATUS_TOPIC_OUTPUTS)
+        {
+            status_outputs_t outputs;
+            sources.outputs(&outputs);
+            is_sent = subscription->is_forced || outputs_changed(&outputs);
+            if (is_sent)
+                encode_outputs(&outputs);
+            last_outputs = outputs;
+        }
+        else
+        {
+            status_stats_t stats;
+            sources.stats(&stats);
+            encode_stats(&stats);
+        }
+
+        if (is_sent)
+        {
+            subscription->is_forced = false;
+            subscription->last_sent_ms = now_ms;
+        }
+    }
+}
+
+// Envia os quadros pendentes: no máximo duas escritas, cada uma com quadros inteiros.
+void status_transmit()
+{
+    if (tx_head < tx_tail)
+    {
+        fwrite(&tx_ring[tx_tail], 1, tx_wrap - tx_tail, stdout);
+        tx_stats.bytes += tx_wrap - tx_tail;
+        tx_tail = 0;
+        tx_wrap = STATUS_TX_RING_SIZE;
+    }
+    if (tx_head > tx_tail)
+    {
+        fwrite(&tx_ring[tx_tail], 1, tx_head - tx_tail, stdout);
+        tx_stats.bytes += tx_head - tx_tail;
+        tx_tail = tx_head;
+    }
+}
+
+void status_get_stats(status_tx_stats_t *stats)
+{
+    *stats = tx_stats;
+}
+
+// Imprime os quadros e bytes enviados, os descartes e as assinaturas ativas.
+void status_report()
+{
+    status_tx_stats_t stats = tx_stats;
+    printf("estado;quadros;%lu;bytes;%lu;descartados;%lu;ocupacao_max;%lu/%u\n", (unsigned long)stats.frames,
+           (unsigned long)stats.bytes, (unsigned long)stats.dropped, (unsigned long)stats.max_pending,
+           STATUS_TX_RING_SIZE);
+    for (int topic = 0; topic < STATUS_TOPIC_COUNT; topic++)
+    {
+        if (subscriptions[topic].is_active)
+            printf("assinatura;%s;intervalo_ms;%lu\n", topic_names[topic],
+                   (unsigned long)subscriptions[topic].interval_ms);
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef STATUS_H
+#define STATUS_H
+
+#include <stdlib.h>
+#include "pico/stdlib.h"
+
+#define STATUS_FRAME_CHANNEL 0x04 // Canal dos quadros de estado no fluxo USB
+#define STATUS_TX_RING_SIZE 512   // Bytes do buffer de transmissão (potência de 2)
+#define STATUS_HEADER_SIZE 7      // Sequência, tópico e instante da codificação
+#define STATUS_TOPIC_ECHO 0xFF    // Resposta ao comando "eco", para medir o atraso do enlace
+
+// Modos ativos na fase (campo de flags do tópico de fase)
+#define STATUS_FLAG_NIGHT (1u << 0)
+#define STATUS_FLAG_FAULT (1u << 1)
+#define STATUS_FLAG_ACTUATED (1u << 2)
+#define STATUS_FLAG_COORDINATED (1u << 3)
+#define STATUS_FLAG_BLINK_ON (1u << 4)
+#define STATUS_FLAG_ADAPTIVE (1u << 5)
+
+typedef enum
+{
+    STATUS_TOPIC_PHASE,   // Fase efetivada: enviada quando muda
+    STATUS_TOPIC_OUTPUTS, // Estado das saídas: enviado quando muda
+    STATUS_TOPIC_STATS,   // Contadores acumulados: enviados a cada intervalo
+    STATUS_TOPIC_COUNT,
+} status_topic_t;
+
+typedef struct status_phase_t
+{
+    uint32_t sequence;    // Número da fronteira de fase
+    uint32_t boundary_us; // Instante da fronteira (32 bits menos significativos)
+    uint8_t light_state;  // Estado do semáforo (0: Verde, 1: Amarelo, 2: Vermelho)
+    uint8_t flags;        // STATUS_FLAG_*
+} status_phase_t;
+
+typedef struct status_outputs_t
+{
+    uint8_t leds;         // LED RGB: bit 0 vermelho, bit 1 verde, bit 2 azul
+    uint8_t matrix_kind;  // Quadro/sequência em exibição na matriz
+    uint16_t buzzer_hz[2]; // Tom dos buzzers A e B (0: desligado)
+} status_outputs_t;
+
+typedef struct status_stats_t
+{
+    uint32_t uptime_ms;
+    uint32_t misses;           // Perdas de prazo de todas as tarefas
+    uint32_t pedestrian_calls; // Chamadas de pedestre atendidas
+    uint32_t max_latency_ms;   // Maior latência chamada-verde
+    uint32_t vehicles;         // Veículos contados pelos detectores
+} status_stats_t;
+
+// Fontes dos instantâneos de cada tópico, chamadas pela tarefa que envia o fluxo.
+typedef struct status_sources_t
+{
+    void (*phase)(status_phase_t *phase);
+    void (*outputs)(status_outputs_t *outputs);
+    void (*stats)(status_stats_t *stats);
+} status_sources_t;
+
+typedef struct status_tx_stats_t
+{
+    uint32_t frames;        // Quadros enviados
+    uint32_t bytes;         // Bytes enviados
+    uint32_t dropped;       // Quadros descartados por falta de espaço no buffer
+    uint32_t max_pending;   // Maior ocupação do buffer de transmissão
+} status_tx_stats_t;
+
+void status_init(const status_sources_t *sources);
+int status_topic_from_name(const char *name);
+bool status_subscribe(int topic, uint32_t interval_ms);
+void status_unsubscribe(int topic);
+void status_echo(uint32_t token);
+void status_service();
+void status_transmit();
+void status_get_stats(status_tx_stats_t *stats);
+void status_report();
+
+#endif // STATUS_H
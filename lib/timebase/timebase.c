@@ -0,0 +1,249 @@
+#include "timebase.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+#include "profiler/xip_profiler.h"
+
+#include "FreeRTOS.h"
+#include "semphr.h"
+
+typedef struct timebase_output_t
+{
+    timebase_prepare_t prepare;
+    timebase_commit_t commit;
+    bool is_deferred; // Saída efetiva o estado fora da interrupção (ex.: display por I2C)
+    timebase_output_stats_t stats;
+} timebase_output_t;
+
+static timebase_output_t outputs[TIMEBASE_MAX_OUTPUTS];
+static uint8_t output_count = 0;
+
+static int alarm_num = -1;
+static timebase_phase_t current;
+static timebase_phase_t pending;
+static volatile bool has_pending = false;
+static uint32_t next_sequence = 0;
+static timebase_stats_t stats;
+static int xip_phase = -1;
+static SemaphoreHandle_t schedule_mutex; // Serializa preparação e armação entre tarefas que agendam fases
+
+// Atualiza as estatísticas de atraso de uma saída em relação à fronteira.
+static void HOT_FUNC(record_offset)(timebase_output_t *output, uint32_t offset_us)
+{
+    output->stats.commits++;
+    output->stats.last_offset_us = offset_us;
+    output->stats.sum_offset_us += offset_us;
+    if (offset_us > output->stats.max_offset_us)
+        output->stats.max_offset_us = offset_us;
+}
+
+static void arm_pending();
+
+// Efetiva a fase pendente em todas as saídas (chamada com interrupções desabilitadas).
+static void HOT_FUNC(commit_pending)()
+{
+    xip_sample_t sample;
+    xip_profiler_begin(&sample);
+    current = pending;
+    has_pending = false;
+
+    uint32_t boundary = (uint32_t)current.boundary_us;
+    uint32_t first = 0, last = 0;
+    bool has_immediate = false;
+    for (uint8_t i = 0; i < output_count; i++)
+    {
+        if (!outputs[i].commit)
+            continue; // Saída que apenas observa as fases agendadas
+
+        bool is_committed = outputs[i].commit(&current);
+        if (outputs[i].is_deferred)
+            continue;
+        if (!is_committed)
+        {
+            outputs[i].stats.refused++; // Fora do desvio: a saída ainda não mudou
+            continue;
+        }
+
+        uint32_t now = time_us_32();
+        record_offset(&outputs[i], now - boundary);
+        if (!has_immediate)
+            first = now;
+        last = now;
+        has_immediate = true;
+    }
+
+    stats.boundaries++;
+    stats.last_skew_us = last - first;
+    if (stats.last_skew_us > stats.max_skew_us)
+        stats.max_skew_us = stats.last_skew_us;
+
+    // No pisca noturno, a próxima metade do ciclo é agendada pelo próprio relógio de fase.
+    if (current.is_night_mode)
+    {
+        pending = current;
+        pending.blink_on = !current.blink_on;
+        pending.sequence = next_sequence++;
+        pending.boundary_us = current.boundary_us + TIMEBASE_BLINK_PERIOD_MS * 1000ull;
+        has_pending = true;
+        arm_pending();
+    }
+    xip_profiler_end(xip_phase, &sample);
+}
+
+// Programa o alarme para a fase pendente. Se o instante já passou, o alarme é programado para logo
+// em seguida em vez de a fase ser efetivada aqui: quem agenda é uma tarefa, e as saídas efetivam
+// sempre no contexto da interrupção (notificações FromISR). Chamada com interrupções desabilitadas.
+static void HOT_FUNC(arm_pending)()
+{
+    if (!hardware_alarm_set_target(alarm_num, from_us_since_boot(pending.boundary_us)))
+        return;
+
+    stats.late_boundaries++;
+    // A espera dobra a cada tentativa perdida, para que a programação caiba nela mesmo com clock baixo
+    for (uint32_t delay_us = 1; hardware_alarm_set_target(alarm_num, from_us_since_boot(time_us_64() + delay_us));
+         delay_us *= 2)
+        ;
+}
+
+static void HOT_FUNC(alarm_callback)(uint alarm)
+{
+    if (has_pending)
+        commit_pending();
+}
+
+// Reserva um alarme de hardware livre para o relógio de fase.
+void timebase_init()
+{
+    alarm_num = hardware_alarm_claim_unused(true); // Sem alarme livre, panic!
+    hardware_alarm_set_callback(alarm_num, alarm_callback);
+    xip_phase = xip_profiler_register("Fronteira");
+    schedule_mutex = xSemaphoreCreateMutex();
+    if (!schedule_mutex)
+        panic("timebase: sem memoria para o mutex de agendamento");
+}
+
+// Registra uma saída; retorna seu identificador ou -1 se não houver espaço.
+int timebase_register_output(const char *name, timebase_prepare_t prepare, timebase_commit_t commit,
+                             bool is_deferred)
+{
+    if (output_count >= TIMEBASE_MAX_OUTPUTS)
+        return -1;
+
+    outputs[output_count] = (timebase_output_t){
+        .prepare = prepare,
+        .commit = commit,
+        .is_deferred = is_deferred,
+        .stats = {.name = name},
+    };
+    return output_count++;
+}
+
+// Agenda uma fase para ser efetivada em todas as saídas no mesmo instante. Chamada apenas por
+// tarefas: o mutex mantém a preparação e a armação de um agendamento juntas, para que as saídas
+// diferidas preparem a mesma fase que será efetivada.
+void timebase_schedule(const timebase_phase_t *phase, uint64_t boundary_us)
+{
+    timebase_phase_t next = *phase;
+    next.boundary_us = boundary_us;
+
+    xSemaphoreTake(schedule_mutex, portMAX_DELAY);
+    // As saídas preparam o próximo estado antes de o alarme ser armado.
+    for (uint8_t i = 0; i < output_count; i++)
+    {
+        if (outputs[i].prepare)
+            outputs[i].prepare(&next);
+    }
+
+    uint32_t irq_state = save_and_disable_interrupts();
+    next.sequence = next_sequence++;
+    pending = next;
+    has_pending = true;
+    arm_pending();
+    restore_interrupts(irq_state);
+    xSemaphoreGive(schedule_mutex);
+}
+
+// Agenda uma fase para a próxima fronteira disponível (agora + antecedência).
+void timebase_publish(const timebase_phase_t *phase)
+{
+    timebase_schedule(phase, time_us_64() + TIMEBASE_LEAD_MS * 1000ull);
+}
+
+// Copia a fase efetivada mais recente.
+void timebase_get_current(timebase_phase_t *phase)
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+    *phase = current;
+    restore_interrupts(irq_state);
+}
+
+// Informa o instante da próxima fronteira agendada, se houver.
+bool timebase_get_pending_boundary(uint64_t *boundary_us)
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+    bool scheduled = has_pending;
+    *boundary_us = pending.boundary_us;
+    restore_interrupts(irq_state);
+    return scheduled;
+}
+
+// Registra o instante em que uma saída diferida efetivou a fronteira.
+void timebase_mark_committed(int output_id, uint64_t boundary_us)
+{
+    if (output_id < 0 || output_id >= output_count)
+        return;
+
+    uint32_t irq_state = save_and_disable_interrupts();
+    record_offset(&outputs[output_id], (uint32_t)(time_us_64() - boundary_us));
+    restore_interrupts(irq_state);
+}
+
+void timebase_get_stats(timebase_stats_t *out)
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+    *out = stats;
+    restore_interrupts(irq_state);
+}
+
+bool timebase_get_output_stats(int output_id, timebase_output_stats_t *out)
+{
+    if (output_id < 0 || output_id >= output_count)
+        return false;
+
+    uint32_t irq_state = save_and_disable_interrupts();
+    *out = outputs[output_id].stats;
+    restore_interrupts(irq_state);
+    return true;
+}
+
+// Zera as estatísticas (ex.: após uma troca de clock, para medir apenas o novo perfil).
+void timebase_reset_stats()
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+    stats = (timebase_stats_t){0};
+    for (uint8_t i = 0; i < output_count; i++)
+        outputs[i].stats = (timebase_output_stats_t){.name = outputs[i].stats.name};
+    restore_interrupts(irq_state);
+}
+
+// Imprime o desvio entre saídas e o atraso de cada saída em relação à fronteira.
+void timebase_report()
+{
+    timebase_stats_t totals;
+    timebase_get_stats(&totals);
+    printf("fronteiras;%lu;atrasadas;%lu;skew_us;%lu;skew_max_us;%lu\n", (unsigned long)totals.boundaries,
+           (unsigned long)totals.late_boundaries, (unsigned long)totals.last_skew_us,
+           (unsigned long)totals.max_skew_us);
+
+    printf("saida;efetivacoes;recusadas;atraso_us;atraso_max_us;atraso_medio_us\n");
+    for (int id = 0; id < output_count; id++)
+    {
+        if (!outputs[id].commit)
+            continue;
+
+        timebase_output_stats_t output;
+        timebase_get_output_stats(id, &output);
+        uint32_t mean_us = output.commits ? (uint32_t)(output.sum_offset_us / output.commits) : 0;
+        printf("%s;%lu;%lu;%lu;%lu;%lu\n", output.name, (unsigned long)output.commits,
+               (unsigned long)output.refused, (unsigned long)output.last_offset_us, (unsigned long)output.max_offset_us, (unsigned long)mean_us);
+    }
+}
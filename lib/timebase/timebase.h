@@ -0,0 +1,60 @@
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include <stdlib.h>
+#include "pico/stdlib.h"
+
+#define TIMEBASE_MAX_OUTPUTS 6         // Número máximo de saídas sincronizadas
+#define TIMEBASE_LEAD_MS 20            // Antecedência entre a publicação e a fronteira de fase
+#define TIMEBASE_BLINK_PERIOD_MS 2000  // Meio período do pisca do modo noturno
+
+typedef struct timebase_phase_t
+{
+    uint8_t light_state; // Estado do semáforo (0: Verde, 1: Amarelo, 2: Vermelho)
+    bool is_night_mode;  // Fase pertence ao pisca noturno
+    bool is_fault_mode;  // Fase pertence ao modo de segurança
+    bool blink_on;       // Metade acesa do pisca noturno
+    uint32_t sequence;   // Número da fronteira de fase
+    uint64_t boundary_us; // Instante programado da fronteira
+} timebase_phase_t;
+
+// Chamada no contexto de quem agenda a fase, para a saída preparar o próximo estado.
+typedef void (*timebase_prepare_t)(const timebase_phase_t *phase);
+// Chamada na interrupção do alarme, na fronteira: deve apenas efetivar o estado preparado.
+// Retorna false se a saída não pôde mudar agora (ex.: DMA ainda ocupado): ela efetiva depois, fora
+// da interrupção, e informa o instante com timebase_mark_committed.
+// Opcional: uma saída sem commit apenas observa as fases agendadas.
+typedef bool (*timebase_commit_t)(const timebase_phase_t *phase);
+
+typedef struct timebase_output_stats_t
+{
+    const char *name;         // Nome da saída
+    uint32_t commits;         // Fronteiras efetivadas
+    uint32_t refused;         // Fronteiras recusadas na interrupção e efetivadas depois
+    uint32_t last_offset_us;  // Atraso da última efetivação em relação à fronteira
+    uint32_t max_offset_us;   // Maior atraso observado
+    uint64_t sum_offset_us;   // Soma dos atrasos (para a média)
+} timebase_output_stats_t;
+
+typedef struct timebase_stats_t
+{
+    uint32_t boundaries;      // Fronteiras efetivadas
+    uint32_t late_boundaries; // Fronteiras agendadas para um instante já passado
+    uint32_t last_skew_us;    // Diferença entre a primeira e a última saída imediata na última fronteira
+    uint32_t max_skew_us;     // Maior diferença observada
+} timebase_stats_t;
+
+void timebase_init();
+int timebase_register_output(const char *name, timebase_prepare_t prepare, timebase_commit_t commit,
+                             bool is_deferred);
+void timebase_schedule(const timebase_phase_t *phase, uint64_t boundary_us);
+void timebase_publish(const timebase_phase_t *phase);
+void timebase_get_current(timebase_phase_t *phase);
+bool timebase_get_pending_boundary(uint64_t *boundary_us);
+void timebase_mark_committed(int output_id, uint64_t boundary_us);
+void timebase_get_stats(timebase_stats_t *stats);
+bool timebase_get_output_stats(int output_id, timebase_output_stats_t *stats);
+void timebase_reset_stats();
+void timebase_report();
+
+#endif // TIMEBASE_H
@@ -0,0 +1,157 @@
+#include "webster.h"
+
+#define WEBSTER_MS_PER_HOUR 3600000u
+#define WEBSTER_FIXED_LOSS_MS 5000u // Termo constante do numerador de Webster (5 s)
+
+// Divide o verde entre as fases na proporção dos pesos (taxas em Q8: os produtos cabem em 32 bits e
+// as divisões usam o divisor de hardware). Uma fase cuja parcela fica abaixo do verde mínimo é fixada
+// nele e sai da divisão; isso reduz as parcelas das demais, então cada passada fixa ao menos uma fase
+// ou encerra (O(fases²) no pior caso). O resto do arredondamento vai para a última fase livre, e o
+// ciclo fecha exatamente. Requer green_ms >= soma dos mínimos.
+static void split_greens(const webster_config_t *config, const uint32_t *weights, uint32_t total_weight,
+                         uint32_t green_ms, uint32_t *greens)
+{
+    uint8_t phases = config->phase_count;
+    bool is_pinned[WEBSTER_MAX_PHASES] = {false};
+    uint32_t remaining_ms = green_ms;
+    uint32_t remaining_weight = total_weight;
+    uint8_t free_phases = phases;
+
+    bool is_changed = true;
+    while (is_changed && free_phases)
+    {
+        is_changed = false;
+        for (uint8_t i = 0; i < phases; i++)
+        {
+            if (is_pinned[i])
+                continue;
+            uint32_t share = remaining_weight ? remaining_ms * weights[i] / remaining_weight : 0;
+            if (share < config->min_green_ms[i])
+            {
+                is_pinned[i] = true;
+                greens[i] = config->min_green_ms[i];
+                remaining_ms -= greens[i];
+                remaining_weight -= weights[i];
+                free_phases--;
+                is_changed = true;
+            }
+        }
+    }
+
+    if (!remaining_weight)
+    {
+        // Sem demanda nas fases livres (inclusive as de verde mínimo zero, que nunca são fixadas): a
+        // sobra é dividida igualmente entre elas, ou entre todas se todas ficaram no verde mínimo
+        uint8_t shares = free_phases ? free_phases : phases;
+        uint8_t last = 0;
+        for (uint8_t i = 0; i < phases; i++)
+        {
+            if (free_phases && is_pinned[i])
+                continue;
+            if (!is_pinned[i])
+                greens[i] = 0;
+            greens[i] += remaining_ms / shares;
+            last = i;
+        }
+        greens[last] += remaining_ms % shares;
+        return;
+    }
+
+    uint32_t assigned_ms = 0;
+    uint8_t last = 0;
+    for (uint8_t i = 0; i < phases; i++)
+    {
+        if (is_pinned[i])
+            continue;
+        greens[i] = remaining_ms * weights[i] / remaining_weight;
+        assigned_ms += greens[i];
+        last = i;
+    }
+    greens[last] += remaining_ms - assigned_ms;
+}
+
+// Valida a configuração e calcula o plano inicial, sem demanda medida.
+bool webster_init(webster_t *optimizer, const webster_config_t *config)
+{
+    if (config->phase_count == 0 || config->phase_count > WEBSTER_MAX_PHASES ||
+        config->approach_count > WEBSTER_MAX_APPROACHES || config->min_cycle_ms > config->max_cycle_ms ||
+        config->max_cycle_ms > WEBSTER_MAX_CYCLE_MS || config->max_ratio_q16 == 0)
+        return false;
+    uint32_t fixed_ms = 0;
+    for (uint8_t i = 0; i < config->phase_count; i++)
+        fixed_ms += config->lost_ms[i] + config->min_green_ms[i];
+    if (fixed_ms > WEBSTER_MAX_CYCLE_MS)
+        return false;
+    for (uint8_t j = 0; j < config->approach_count; j++)
+    {
+        if (config->approaches[j].phase >= config->phase_count || config->approaches[j].saturation_per_h == 0)
+            return false;
+    }
+
+    *optimizer = (webster_t){.config = *config};
+    uint16_t counts[WEBSTER_MAX_APPROACHES] = {0};
+    webster_update(optimizer, counts, config->min_cycle_ms ? config->min_cycle_ms : 1);
+    optimizer->updates = 0;
+    return true;
+}
+
+// Atualiza as taxas com as contagens de um ciclo de cycle_ms e recalcula ciclo e verdes.
+// O plano retornado vale até a próxima chamada.
+const webster_plan_t *webster_update(webster_t *optimizer, const uint16_t *counts, uint32_t cycle_ms)
+{
+    const webster_config_t *config = &optimizer->config;
+    webster_plan_t *plan = &optimizer->plan;
+    if (cycle_ms == 0)
+        cycle_ms = plan->cycle_ms ? plan->cycle_ms : 1;
+
+    // Taxa medida de cada aproximação (Q16) e média móvel
+    uint32_t phase_ratios[WEBSTER_MAX_PHASES] = {0};
+    for (uint8_t j = 0; j < config->approach_count; j++)
+    {
+        const webster_approach_t *approach = &config->approaches[j];
+        uint64_t measured = ((uint64_t)counts[j] * WEBSTER_MS_PER_HOUR << 16) /
+                            ((uint64_t)cycle_ms * approach->saturation_per_h);
+        if (measured > WEBSTER_MAX_RATIO_Q16)
+            measured = WEBSTER_MAX_RATIO_Q16;
+
+        int32_t error = (int32_t)measured - (int32_t)optimizer->ratio_q16[j];
+        optimizer->ratio_q16[j] += error * config->smoothing_q8 / 256;
+
+        if (optimizer->ratio_q16[j] > phase_ratios[approach->phase])
+            phase_ratios[approach->phase] = optimizer->ratio_q16[j]; // Aproximação crítica da fase
+    }
+
+    uint32_t ratio = 0, lost_ms = 0, min_greens_ms = 0;
+    uint32_t weights[WEBSTER_MAX_PHASES], total_weight = 0;
+    for (uint8_t i = 0; i < config->phase_count; i++)
+    {
+        ratio += phase_ratios[i];
+        weights[i] = phase_ratios[i] >> 8;
+        total_weight += weights[i];
+        lost_ms += config->lost_ms[i];
+        min_greens_ms += config->min_green_ms[i];
+    }
+
+    uint32_t cycle;
+    plan->is_saturated = ratio >= config->max_ratio_q16;
+    if (plan->is_saturated)
+    {
+        cycle = config->max_cycle_ms;
+    }
+    else
+    {
+        cycle = (uint32_t)(((uint64_t)(3 * lost_ms / 2 + WEBSTER_FIXED_LOSS_MS) << 16) / (WEBSTER_Q16_ONE - ratio));
+        if (cycle < config->min_cycle_ms)
+            cycle = config->min_cycle_ms;
+        if (cycle > config->max_cycle_ms)
+            cycle = config->max_cycle_ms;
+    }
+    if (cycle < lost_ms + min_greens_ms)
+        cycle = lost_ms + min_greens_ms; // Os mínimos de segurança prevalecem sobre o ciclo máximo
+
+    split_greens(config, weights, total_weight, cycle - lost_ms, plan->green_ms);
+    plan->cycle_ms = cycle;
+    plan->ratio_q16 = ratio;
+    optimizer->updates++;
+    return plan;
+}
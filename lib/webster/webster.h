@@ -0,0 +1,62 @@
+#ifndef WEBSTER_H
+#define WEBSTER_H
+
+// Núcleo portátil do plano de tempos adaptativo pelo modelo de Webster: a cada ciclo, as contagens
+// de demanda por aproximação viram taxas de ocupação (fluxo / fluxo de saturação), e o ciclo ótimo
+// e a divisão dos verdes são recalculados. Apenas aritmética inteira e ponto fixo Q16, sem divisões
+// em ponto flutuante, para caber no orçamento por ciclo do Cortex-M0+. Não depende do SDK do Pico.
+//
+//     C = (1,5 L + 5 s) / (1 - Y)        g_i = (C - L) Y_i / Y
+//
+// L é a soma dos tempos perdidos das fases, Y_i a maior taxa entre as aproximações atendidas pela
+// fase i e Y a soma das Y_i. Fases cuja parcela fica abaixo do verde mínimo são fixadas no mínimo e
+// o restante é redistribuído entre as demais.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define WEBSTER_MAX_PHASES 8
+#define WEBSTER_MAX_APPROACHES 16
+#define WEBSTER_Q16_ONE 65536u
+#define WEBSTER_MAX_RATIO_Q16 (2 * WEBSTER_Q16_ONE) // Taxa por aproximação limitada a 2 (demanda medida)
+#define WEBSTER_MAX_CYCLE_MS 300000u // Limite do ciclo máximo: verde x peso Q8 cabe em 32 bits
+
+typedef struct webster_approach_t
+{
+    uint8_t phase;              // Fase que atende a aproximação
+    uint16_t saturation_per_h;  // Fluxo de saturação (unidades por hora de verde)
+} webster_approach_t;
+
+typedef struct webster_config_t
+{
+    uint8_t phase_count;
+    uint8_t approach_count;
+    webster_approach_t approaches[WEBSTER_MAX_APPROACHES];
+    uint32_t lost_ms[WEBSTER_MAX_PHASES];      // Tempo perdido por fase (partida e limpeza)
+    uint32_t min_green_ms[WEBSTER_MAX_PHASES]; // Verde mínimo por fase
+    uint32_t min_cycle_ms;
+    uint32_t max_cycle_ms;
+    uint16_t max_ratio_q16; // Y a partir do qual a interseção é tratada como saturada (ciclo máximo)
+    uint16_t smoothing_q8;  // Peso da nova medição na média móvel das taxas (256: sem média)
+} webster_config_t;
+
+typedef struct webster_plan_t
+{
+    uint32_t cycle_ms;                     // Duração do ciclo
+    uint32_t green_ms[WEBSTER_MAX_PHASES]; // Verde efetivo de cada fase; ciclo = soma dos verdes + L
+    uint32_t ratio_q16;                    // Y do plano
+    bool is_saturated;                     // Y acima do limite: ciclo máximo
+} webster_plan_t;
+
+typedef struct webster_t
+{
+    webster_config_t config;
+    uint32_t ratio_q16[WEBSTER_MAX_APPROACHES]; // Média móvel da taxa de cada aproximação
+    uint32_t updates;                           // Planos calculados
+    webster_plan_t plan;                        // Último plano
+} webster_t;
+
+bool webster_init(webster_t *optimizer, const webster_config_t *config);
+const webster_plan_t *webster_update(webster_t *optimizer, const uint16_t *counts, uint32_t cycle_ms);
+
+#endif // WEBSTER_H
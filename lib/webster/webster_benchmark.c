@@ -0,0 +1,104 @@
+#include <stdio.h>
+#include "webster_benchmark.h"
+#include "webster.h"
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+
+#define WEBSTER_BENCHMARK_CALLS 500
+#define WEBSTER_BENCHMARK_CYCLE_MS 60000
+
+typedef struct bench_size_t
+{
+    uint8_t phases;
+    uint8_t approaches;
+    bool is_min_green_zero; // Sem verde mínimo: com demanda nula, nenhuma fase é fixada
+} bench_size_t;
+
+static const bench_size_t sizes[] = {
+    {2, 2}, {2, 4}, {4, 4}, {4, 8}, {8, 8}, {8, WEBSTER_MAX_APPROACHES}, {4, 8, true},
+};
+
+// Gerador congruente linear: contagens reproduzíveis entre execuções
+static uint32_t bench_seed = 1;
+
+static uint32_t bench_random()
+{
+    bench_seed = bench_seed * 1664525u + 1013904223u;
+    return bench_seed >> 16;
+}
+
+// Configuração com verdes mínimos desiguais, para que a divisão fixe fases em passadas sucessivas, ou
+// nulos, para o caso em que a divisão fica sem peso algum.
+static void bench_config(webster_config_t *config, const bench_size_t *size)
+{
+    *config = (webster_config_t){
+        .phase_count = size->phases,
+        .approach_count = size->approaches,
+        .min_cycle_ms = 30000,
+        .max_cycle_ms = 120000,
+        .max_ratio_q16 = 58982, // 0,9
+        .smoothing_q8 = 64,
+    };
+    for (uint8_t i = 0; i < size->phases; i++)
+    {
+        config->lost_ms[i] = 3000;
+        config->min_green_ms[i] = size->is_min_green_zero ? 0 : 1000 + 1500 * i;
+    }
+    for (uint8_t j = 0; j < size->approaches; j++)
+        config->approaches[j] = (webster_approach_t){.phase = j % size->phases, .saturation_per_h = 1800};
+}
+
+// Contagens de um ciclo: sem demanda, saturado ou aleatório, para percorrer todos os ramos.
+static void bench_counts(uint16_t *counts, uint8_t approaches, uint32_t call)
+{
+    for (uint8_t j = 0; j < approaches; j++)
+    {
+        if (call % 8 == 0)
+            counts[j] = 0;
+        else if (call % 8 == 1)
+            counts[j] = 60; // Acima do fluxo de saturação no ciclo de 60 s
+        else
+            counts[j] = bench_random() % 16 < 3 ? 0 : bench_random() % 30;
+    }
+}
+
+// Tempo de webster_update por tamanho de interseção, com as interrupções desligadas, contra o
+// orçamento por ciclo. Imprime a média e o pior caso em microssegundos.
+void webster_benchmark()
+{
+    static webster_t optimizer;
+    webster_config_t config;
+    uint16_t counts[WEBSTER_MAX_APPROACHES];
+
+    printf("webster;clk_mhz;%lu;orcamento_us;%u\n", (unsigned long)(clock_get_hz(clk_sys) / 1000000),
+           WEBSTER_CYCLE_BUDGET_US);
+    printf("fases;aproximacoes;verde_minimo_zero;chamadas;us_medio;pior_us;dentro_do_orcamento\n");
+    for (uint i = 0; i < count_of(sizes); i++)
+    {
+        bench_config(&config, &sizes[i]);
+        if (!webster_init(&optimizer, &config))
+            continue;
+
+        bench_seed = 1;
+        uint32_t total_us = 0, worst_us = 0;
+        for (uint32_t call = 0; call < WEBSTER_BENCHMARK_CALLS; call++)
+        {
+            bench_counts(counts, sizes[i].approaches, call);
+
+            uint32_t irq_state = save_and_disable_interrupts();
+            uint32_t start_us = time_us_32();
+            webster_update(&optimizer, counts, WEBSTER_BENCHMARK_CYCLE_MS);
+            uint32_t elapsed_us = time_us_32() - start_us;
+            restore_interrupts(irq_state);
+
+            total_us += elapsed_us;
+            if (elapsed_us > worst_us)
+                worst_us = elapsed_us;
+        }
+        printf("%u;%u;%s;%u;%lu;%lu;%s\n", sizes[i].phases, sizes[i].approaches,
+               sizes[i].is_min_green_zero ? "sim" : "nao", WEBSTER_BENCHMARK_CALLS,
+               (unsigned long)(total_us / WEBSTER_BENCHMARK_CALLS), (unsigned long)worst_us,
+               worst_us <= WEBSTER_CYCLE_BUDGET_US ? "sim" : "nao");
+    }
+}
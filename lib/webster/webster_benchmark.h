@@ -0,0 +1,8 @@
+#ifndef WEBSTER_BENCHMARK_H
+#define WEBSTER_BENCHMARK_H
+
+#define WEBSTER_CYCLE_BUDGET_US 200 // Orçamento do plano por ciclo, parte do WCET da tarefa de controle
+
+void webster_benchmark();
+
+#endif // WEBSTER_BENCHMARK_H
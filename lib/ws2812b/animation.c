@@ -0,0 +1,136 @@
+#include "animation.h"
+#include "profiler/xip_profiler.h"
+
+// Correção gama (2,2) de 8 bits: valor linear -> intensidade do LED.
+static const uint8_t gamma8[256] = {
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+      3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,
+      6,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,  12,
+     12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,
+     20,  20,  21,  22,  22,  23,  23,  24,  25,  25,  26,  26,  27,  28,  28,  29,
+     30,  30,  31,  32,  33,  33,  34,  35,  35,  36,  37,  38,  39,  39,  40,  41,
+     42,  43,  43,  44,  45,  46,  47,  48,  49,  49,  50,  51,  52,  53,  54,  55,
+     56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,
+     73,  74,  75,  76,  77,  78,  79,  81,  82,  83,  84,  85,  87,  88,  89,  90,
+     91,  93,  94,  95,  97,  98,  99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+    113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+    137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+    163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+    192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+    223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255,
+};
+
+// Perfil do pulso: (1 - cos(2*pi*i/256)) / 2 em Q8, de 0 ao máximo e de volta a 0.
+static const uint8_t HOT_DATA pulse8[256] = {
+      0,   0,   0,   0,   1,   1,   1,   2,   2,   3,   4,   5,   5,   6,   7,   9,
+     10,  11,  12,  14,  15,  17,  18,  20,  21,  23,  25,  27,  29,  31,  33,  35,
+     37,  40,  42,  44,  47,  49,  52,  54,  57,  59,  62,  65,  67,  70,  73,  76,
+     79,  82,  85,  88,  90,  93,  97, 100, 103, 106, 109, 112, 115, 118, 121, 124,
+    127, 131, 134, 137, 140, 143, 146, 149, 152, 155, 158, 162, 165, 167, 170, 173,
+    176, 179, 182, 185, 188, 190, 193, 196, 198, 201, 203, 206, 208, 211, 213, 215,
+    218, 220, 222, 224, 226, 228, 230, 232, 234, 235, 237, 238, 240, 241, 243, 244,
+    245, 246, 248, 249, 250, 250, 251, 252, 253, 253, 254, 254, 254, 255, 255, 255,
+    255, 255, 255, 255, 254, 254, 254, 253, 253, 252, 251, 250, 250, 249, 248, 246,
+    245, 244, 243, 241, 240, 238, 237, 235, 234, 232, 230, 228, 226, 224, 222, 220,
+    218, 215, 213, 211, 208, 206, 203, 201, 198, 196, 193, 190, 188, 185, 182, 179,
+    176, 173, 170, 167, 165, 162, 158, 155, 152, 149, 146, 143, 140, 137, 134, 131,
+    128, 124, 121, 118, 115, 112, 109, 106, 103, 100,  97,  93,  90,  88,  85,  82,
+     79,  76,  73,  70,  67,  65,  62,  59,  57,  54,  52,  49,  47,  44,  42,  40,
+     37,  35,  33,  31,  29,  27,  25,  23,  21,  20,  18,  17,  15,  14,  12,  11,
+     10,   9,   7,   6,   5,   5,   4,   3,   2,   2,   1,   1,   1,   0,   0,   0,
+};
+
+// Gama combinado com o brilho global; refeita apenas quando o brilho muda.
+static uint8_t output_lut[256];
+static bool output_lut_ready = false;
+
+// Define o brilho global e recalcula a tabela de saída.
+void animation_set_brightness(uint8_t brightness)
+{
+    for (uint i = 0; i < 256; i++)
+        output_lut[i] = (gamma8[i] * brightness + 127) / 255;
+    output_lut_ready = true;
+}
+
+// Interpolação linear em Q8 entre dois canais.
+static inline uint8_t lerp8(uint8_t from, uint8_t to, uint32_t weight)
+{
+    return from + (((int32_t)to - from) * (int32_t)weight >> 8);
+}
+
+// Desenha no buffer da matriz o quadro da sequência no instante informado.
+void HOT_FUNC(animation_render)(const anim_sequence_t *sequence, uint32_t time_ms)
+{
+    if (!output_lut_ready)
+        animation_set_brightness(ANIMATION_DEFAULT_BRIGHTNESS);
+
+    // Localiza o quadro-chave ativo (poucos quadros-chave: busca linear)
+    uint32_t total_ms = 0;
+    for (uint8_t k = 0; k < sequence->count; k++)
+        total_ms += sequence->keyframes[k].duration_ms;
+    if (total_ms == 0)
+        return;
+
+    if (sequence->loop)
+        time_ms %= total_ms;
+    else if (time_ms >= total_ms)
+        time_ms = total_ms - 1;
+
+    uint8_t k = 0;
+    while (time_ms >= sequence->keyframes[k].duration_ms)
+        time_ms -= sequence->keyframes[k++].duration_ms;
+
+    const anim_keyframe_t *key = &sequence->keyframes[k];
+    const anim_keyframe_t *next = &sequence->keyframes[(k + 1) % sequence->count];
+    if (!sequence->loop && k + 1 == sequence->count)
+        next = key;
+
+    // Uma única divisão por quadro: o restante é inteiro e por tabela
+    uint32_t weight = (time_ms << 8) / key->duration_ms; // Q8, 0..255
+
+    for (uint i = 0; i < LED_MATRIX_SIZE; i++)
+    {
+        anim_color_t color = key->frame[i];
+
+        if (key->transition == ANIM_FADE)
+        {
+            color.r = lerp8(color.r, next->frame[i].r, weight);
+            color.g = lerp8(color.g, next->frame[i].g, weight);
+            color.b = lerp8(color.b, next->frame[i].b, weight);
+        }
+        else if (key->transition == ANIM_PULSE)
+        {
+            uint32_t level = pulse8[weight];
+            color.r = color.r * level >> 8;
+            color.g = color.g * level >> 8;
+            color.b = color.b * level >> 8;
+        }
+
+        led_matrix[i].R = output_lut[color.r];
+        led_matrix[i].G = output_lut[color.g];
+        led_matrix[i].B = output_lut[color.b];
+    }
+}
+
+// Mede o tempo médio e o pior tempo de renderização de um quadro da sequência.
+void animation_benchmark(const anim_sequence_t *sequence)
+{
+    const uint frames = 1000;
+    uint32_t worst_us = 0;
+    uint32_t start_us = time_us_32();
+
+    for (uint i = 0; i < frames; i++)
+    {
+        uint32_t frame_start = time_us_32();
+        animation_render(sequence, i * (ANIMATION_FRAME_US / 1000));
+        uint32_t elapsed = time_us_32() - frame_start;
+        if (elapsed > worst_us)
+            worst_us = elapsed;
+    }
+
+    uint32_t total_us = time_us_32() - start_us;
+    printf("animacao;quadros;%u;us_por_quadro;%lu.%02lu;pior_us;%lu;orcamento_us;%u\n", frames,
+           (unsigned long)(total_us / frames), (unsigned long)(total_us % frames / (frames / 100)),
+           (unsigned long)worst_us, ANIMATION_FRAME_US);
+}
@@ -0,0 +1,43 @@
+#ifndef WS2812B_ANIMATION_H
+#define WS2812B_ANIMATION_H
+
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "ws2812b.h"
+
+#define ANIMATION_FPS 60
+#define ANIMATION_FRAME_US (1000000 / ANIMATION_FPS) // Orçamento de cada quadro
+#define ANIMATION_DEFAULT_BRIGHTNESS 16             // Brilho global (0-255) após a correção gama
+
+// Cor linear de 8 bits por canal, antes da correção gama e do brilho global.
+typedef struct anim_color_t
+{
+    uint8_t r, g, b;
+} anim_color_t;
+
+typedef enum
+{
+    ANIM_HOLD,  // Mantém o quadro-chave
+    ANIM_FADE,  // Transição linear até o próximo quadro-chave
+    ANIM_PULSE, // Pulso (0 -> quadro -> 0) com perfil cossenoidal
+} anim_transition_t;
+
+typedef struct anim_keyframe_t
+{
+    const anim_color_t *frame; // LED_MATRIX_SIZE cores lineares
+    uint16_t duration_ms;      // Duração do quadro-chave
+    uint8_t transition;        // anim_transition_t
+} anim_keyframe_t;
+
+typedef struct anim_sequence_t
+{
+    const anim_keyframe_t *keyframes;
+    uint8_t count;
+    bool loop; // Reinicia ao fim; caso contrário mantém o último quadro
+} anim_sequence_t;
+
+void animation_set_brightness(uint8_t brightness);
+void animation_render(const anim_sequence_t *sequence, uint32_t time_ms);
+void animation_benchmark(const anim_sequence_t *sequence);
+
+#endif // WS2812B_ANIMATION_H
@@ -0,0 +1,175 @@
+#include <string.h>
+#include "canvas.h"
+
+#define CANVAS_GLYPH(c) ((c) - ' ')
+#define CANVAS_GLYPH_COUNT (CANVAS_GLYPH('Z') + 1)
+
+// Fonte 3x5 (espaço a 'Z'), no mesmo formato dos sprites. Minúsculas usam os glifos maiúsculos.
+static const uint8_t font3x5[CANVAS_GLYPH_COUNT][CANVAS_FONT_HEIGHT] = {
+    [CANVAS_GLYPH(' ')] = {0x00, 0x00, 0x00, 0x00, 0x00},
+    [CANVAS_GLYPH('!')] = {0x40, 0x40, 0x40, 0x00, 0x40},
+    [CANVAS_GLYPH('-')] = {0x00, 0x00, 0xE0, 0x00, 0x00},
+    [CANVAS_GLYPH('.')] = {0x00, 0x00, 0x00, 0x00, 0x40},
+    [CANVAS_GLYPH('0')] = {0xE0, 0xA0, 0xA0, 0xA0, 0xE0},
+    [CANVAS_GLYPH('1')] = {0x40, 0xC0, 0x40, 0x40, 0xE0},
+    [CANVAS_GLYPH('2')] = {0xE0, 0x20, 0xE0, 0x80, 0xE0},
+    [CANVAS_GLYPH('3')] = {0xE0, 0x20, 0x60, 0x20, 0xE0},
+    [CANVAS_GLYPH('4')] = {0xA0, 0xA0, 0xE0, 0x20, 0x20},
+    [CANVAS_GLYPH('5')] = {0xE0, 0x80, 0xE0, 0x20, 0xE0},
+    [CANVAS_GLYPH('6')] = {0xE0, 0x80, 0xE0, 0xA0, 0xE0},
+    [CANVAS_GLYPH('7')] = {0xE0, 0x20, 0x40, 0x40, 0x40},
+    [CANVAS_GLYPH('8')] = {0xE0, 0xA0, 0xE0, 0xA0, 0xE0},
+    [CANVAS_GLYPH('9')] = {0xE0, 0xA0, 0xE0, 0x20, 0xE0},
+    [CANVAS_GLYPH(':')] = {0x00, 0x40, 0x00, 0x40, 0x00},
+    [CANVAS_GLYPH('A')] = {0x40, 0xA0, 0xE0, 0xA0, 0xA0},
+    [CANVAS_GLYPH('B')] = {0xC0, 0xA0, 0xC0, 0xA0, 0xC0},
+    [CANVAS_GLYPH('C')] = {0x60, 0x80, 0x80, 0x80, 0x60},
+    [CANVAS_GLYPH('D')] = {0xC0, 0xA0, 0xA0, 0xA0, 0xC0},
+    [CANVAS_GLYPH('E')] = {0xE0, 0x80, 0xC0, 0x80, 0xE0},
+    [CANVAS_GLYPH('F')] = {0xE0, 0x80, 0xC0, 0x80, 0x80},
+    [CANVAS_GLYPH('G')] = {0x60, 0x80, 0xA0, 0xA0, 0x60},
+    [CANVAS_GLYPH('H')] = {0xA0, 0xA0, 0xE0, 0xA0, 0xA0},
+    [CANVAS_GLYPH('I')] = {0xE0, 0x40, 0x40, 0x40, 0xE0},
+    [CANVAS_GLYPH('J')] = {0x20, 0x20, 0x20, 0xA0, 0x40},
+    [CANVAS_GLYPH('K')] = {0xA0, 0xA0, 0xC0, 0xA0, 0xA0},
+    [CANVAS_GLYPH('L')] = {0x80, 0x80, 0x80, 0x80, 0xE0},
+    [CANVAS_GLYPH('M')] = {0xA0, 0xE0, 0xE0, 0xA0, 0xA0},
+    [CANVAS_GLYPH('N')] = {0xC0, 0xA0, 0xA0, 0xA0, 0xA0},
+    [CANVAS_GLYPH('O')] = {0x40, 0xA0, 0xA0, 0xA0, 0x40},
+    [CANVAS_GLYPH('P')] = {0xC0, 0xA0, 0xC0, 0x80, 0x80},
+    [CANVAS_GLYPH('Q')] = {0x40, 0xA0, 0xA0, 0xC0, 0x60},
+    [CANVAS_GLYPH('R')] = {0xC0, 0xA0, 0xC0, 0xA0, 0xA0},
+    [CANVAS_GLYPH('S')] = {0x60, 0x80, 0x40, 0x20, 0xC0},
+    [CANVAS_GLYPH('T')] = {0xE0, 0x40, 0x40, 0x40, 0x40},
+    [CANVAS_GLYPH('U')] = {0xA0, 0xA0, 0xA0, 0xA0, 0xE0},
+    [CANVAS_GLYPH('V')] = {0xA0, 0xA0, 0xA0, 0xA0, 0x40},
+    [CANVAS_GLYPH('W')] = {0xA0, 0xA0, 0xE0, 0xE0, 0xA0},
+    [CANVAS_GLYPH('X')] = {0xA0, 0xA0, 0x40, 0xA0, 0xA0},
+    [CANVAS_GLYPH('Y')] = {0xA0, 0xA0, 0x40, 0x40, 0x40},
+    [CANVAS_GLYPH('Z')] = {0xE0, 0x20, 0x40, 0x80, 0xE0},
+};
+
+// Limpa o quadro (todos os LEDs apagados).
+void canvas_clear(anim_color_t *frame)
+{
+    canvas_fill(frame, (anim_color_t){0, 0, 0});
+}
+
+// Preenche o quadro inteiro com uma cor.
+void canvas_fill(anim_color_t *frame, anim_color_t color)
+{
+    for (uint i = 0; i < LED_MATRIX_SIZE; i++)
+        frame[i] = color;
+}
+
+// Acende um pixel; coordenadas fora da matriz são ignoradas.
+void canvas_pixel(anim_color_t *frame, int x, int y, anim_color_t color)
+{
+    if ((uint)x >= LED_MATRIX_COL || (uint)y >= LED_MATRIX_ROW)
+        return;
+
+    frame[ws2812b_index(x, y)] = color;
+}
+
+// Preenche uma linha inteira.
+void canvas_row(anim_color_t *frame, int y, anim_color_t color)
+{
+    if ((uint)y >= LED_MATRIX_ROW)
+        return;
+
+    for (uint x = 0; x < LED_MATRIX_COL; x++)
+        frame[ws2812b_index(x, y)] = color;
+}
+
+// Preenche uma coluna inteira.
+void canvas_column(anim_color_t *frame, int x, anim_color_t color)
+{
+    if ((uint)x >= LED_MATRIX_COL)
+        return;
+
+    for (uint y = 0; y < LED_MATRIX_ROW; y++)
+        frame[ws2812b_index(x, y)] = color;
+}
+
+// Desenha um retângulo preenchido ou apenas o contorno.
+void canvas_rect(anim_color_t *frame, int x, int y, int width, int height, anim_color_t color, bool fill)
+{
+    for (int row = 0; row < height; row++)
+    {
+        bool is_edge_row = row == 0 || row == height - 1;
+        for (int col = 0; col < width; col++)
+        {
+            if (fill || is_edge_row || col == 0 || col == width - 1)
+                canvas_pixel(frame, x + col, y + row, color);
+        }
+    }
+}
+
+// Desenha os bits acesos de um sprite com o canto superior esquerdo em (x, y).
+void canvas_blit(anim_color_t *frame, const canvas_sprite_t *sprite, int x, int y, anim_color_t color)
+{
+    for (int row = 0; row < sprite->height; row++)
+    {
+        uint8_t bits = sprite->rows[row];
+        for (int col = 0; col < sprite->width; col++)
+        {
+            if (bits & (0x80 >> col))
+                canvas_pixel(frame, x + col, y + row, color);
+        }
+    }
+}
+
+// Desenha um caractere e retorna o avanço horizontal; caracteres sem glifo ficam em branco.
+int canvas_char(anim_color_t *frame, char c, int x, int y, anim_color_t color)
+{
+    if (c >= 'a' && c <= 'z')
+        c -= 'a' - 'A';
+    if (c < ' ' || c > 'Z')
+        c = ' ';
+
+    canvas_sprite_t glyph = {CANVAS_FONT_WIDTH, CANVAS_FONT_HEIGHT, font3x5[CANVAS_GLYPH(c)]};
+    canvas_blit(frame, &glyph, x, y, color);
+    return CANVAS_FONT_ADVANCE;
+}
+
+// Desenha um texto a partir de (x, y) e retorna sua largura em pixels.
+int canvas_text(anim_color_t *frame, const char *text, int x, int y, anim_color_t color)
+{
+    int start = x;
+    for (; *text; text++)
+    {
+        // Caracteres totalmente fora da matriz não precisam ser desenhados.
+        if (x + CANVAS_FONT_WIDTH > 0 && x < LED_MATRIX_COL)
+            canvas_char(frame, *text, x, y, color);
+        x += CANVAS_FONT_ADVANCE;
+    }
+    return x - start;
+}
+
+int canvas_text_width(const char *text)
+{
+    return (int)strlen(text) * CANVAS_FONT_ADVANCE;
+}
+
+// Prepara o texto para entrar pela borda direita da matriz.
+void canvas_ticker_init(canvas_ticker_t *ticker, const char *text)
+{
+    ticker->text = text;
+    ticker->offset = 0;
+    ticker->span = canvas_text_width(text) + LED_MATRIX_COL;
+}
+
+// Desenha a posição atual do texto, centralizado na vertical.
+void canvas_ticker_draw(anim_color_t *frame, const canvas_ticker_t *ticker, anim_color_t color)
+{
+    canvas_text(frame, ticker->text, LED_MATRIX_COL - ticker->offset, (LED_MATRIX_ROW - CANVAS_FONT_HEIGHT) / 2,
+                color);
+}
+
+// Avança o texto um pixel para a esquerda; ao sair por completo, reinicia pela direita.
+void canvas_ticker_step(canvas_ticker_t *ticker)
+{
+    ticker->offset++;
+    if (ticker->offset >= ticker->span)
+        ticker->offset = 0;
+}
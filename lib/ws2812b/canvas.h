@@ -0,0 +1,45 @@
+#ifndef WS2812B_CANVAS_H
+#define WS2812B_CANVAS_H
+
+#include <stdlib.h>
+#include "pico/stdlib.h"
+#include "ws2812b.h"
+#include "animation.h"
+
+#define CANVAS_FONT_WIDTH 3   // Largura dos glifos da fonte
+#define CANVAS_FONT_HEIGHT 5  // Altura dos glifos da fonte
+#define CANVAS_FONT_ADVANCE 4 // Avanço horizontal por caractere (glifo + espaço)
+
+// Imagem de 1 bit: uma linha por byte, bit mais significativo = pixel da esquerda.
+typedef struct canvas_sprite_t
+{
+    uint8_t width;       // Largura em pixels (até 8)
+    uint8_t height;      // Altura em pixels (uma entrada de rows por linha)
+    const uint8_t *rows; // Linhas da imagem, de cima para baixo
+} canvas_sprite_t;
+
+// Texto rolando da direita para a esquerda, na altura central da matriz.
+typedef struct canvas_ticker_t
+{
+    const char *text;
+    int16_t offset;   // Deslocamento atual em pixels
+    uint16_t span;    // Pixels percorridos até o texto reaparecer à direita
+} canvas_ticker_t;
+
+// Todas as funções desenham em um quadro de LED_MATRIX_SIZE cores lineares, indexado
+// como a matriz física; coordenadas fora da matriz são descartadas.
+void canvas_clear(anim_color_t *frame);
+void canvas_fill(anim_color_t *frame, anim_color_t color);
+void canvas_pixel(anim_color_t *frame, int x, int y, anim_color_t color);
+void canvas_row(anim_color_t *frame, int y, anim_color_t color);
+void canvas_column(anim_color_t *frame, int x, anim_color_t color);
+void canvas_rect(anim_color_t *frame, int x, int y, int width, int height, anim_color_t color, bool fill);
+void canvas_blit(anim_color_t *frame, const canvas_sprite_t *sprite, int x, int y, anim_color_t color);
+int canvas_char(anim_color_t *frame, char c, int x, int y, anim_color_t color);
+int canvas_text(anim_color_t *frame, const char *text, int x, int y, anim_color_t color);
+int canvas_text_width(const char *text);
+void canvas_ticker_init(canvas_ticker_t *ticker, const char *text);
+void canvas_ticker_draw(anim_color_t *frame, const canvas_ticker_t *ticker, anim_color_t color);
+void canvas_ticker_step(canvas_ticker_t *ticker);
+
+#endif // WS2812B_CANVAS_H
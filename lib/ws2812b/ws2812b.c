@@ -1,94 +1,379 @@
 #include "ws2812b.h"
 #include "ws2812b.pio.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "log/log.h"
+#include "profiler/xip_profiler.h"
 
 ws2812b_LED_t led_matrix[LED_MATRIX_SIZE];
-PIO led_matrix_pio;
-uint sm;
+ws2812b_t ws2812b_matrix = {.dma_chan = -1};
 
-// Inicializa a máquina PIO para controle da matriz de LEDs.
-void ws2812b_init(uint pin)
-{
+// Posição de cada programa em cada bloco PIO (-1 enquanto não carregado).
+static int serial_offset[2] = {-1, -1};
+static int parallel_offset[2] = {-1, -1};
 
-    // Cria programa PIO.
-    uint offset = pio_add_program(pio0, &led_matrix_program);
-    led_matrix_pio = pio0;
+// Tabela de índices gerada pelo pré-processador para qualquer dimensão da matriz.
+#define WS2812B_INDEX_CELL(x, y) WS2812B_INDEX(x, y),
+#define WS2812B_INDEX_ROW(y, unused) {WS2812B_REPEAT_X(LED_MATRIX_COL, WS2812B_INDEX_CELL, y)},
+const uint16_t HOT_DATA ws2812b_index_map[LED_MATRIX_ROW][LED_MATRIX_COL] = {
+    WS2812B_REPEAT_Y(LED_MATRIX_ROW, WS2812B_INDEX_ROW, 0)};
 
-    // Toma posse de uma máquina PIO.
-    sm = pio_claim_unused_sm(led_matrix_pio, false);
-    if (sm < 0)
+// Toma posse de uma máquina PIO, preferindo pio0, e carrega o programa no bloco uma única vez.
+static void claim_state_machine(const pio_program_t *program, int offsets[2], PIO *pio, uint *sm, uint *offset)
+{
+    PIO blocks[2] = {pio0, pio1};
+    for (uint i = 0; i < 2; i++)
     {
-        led_matrix_pio = pio1;
-        sm = pio_claim_unused_sm(led_matrix_pio, true); // Se nenhuma máquina estiver livre, panic!
+        if (offsets[i] < 0 && !pio_can_add_program(blocks[i], program))
+            continue;
+
+        int claimed = pio_claim_unused_sm(blocks[i], i == 1); // Se nenhuma máquina estiver livre, panic!
+        if (claimed < 0)
+            continue;
+
+        if (offsets[i] < 0)
+            offsets[i] = pio_add_program(blocks[i], program);
+        *pio = blocks[i];
+        *sm = claimed;
+        *offset = offsets[i];
+        return;
     }
+    panic("ws2812b: sem máquina PIO livre");
+}
+
+// Verdadeiro depois que o quadro anterior saiu inteiro e a linha ficou o reset em nível baixo.
+// O tempo de envio é determinado pela taxa de bits: o DMA alimenta a FIFO mais rápido que a PIO a esvazia.
+static inline bool HOT_FUNC(is_reset_done)(uint32_t ready_us)
+{
+    return (int32_t)(time_us_32() - ready_us) >= 0;
+}
+
+// Inicializa uma fita com seu próprio buffer de pixels e máquina PIO.
+void ws2812b_strip_init(ws2812b_t *strip, uint pin, ws2812b_LED_t *pixels, uint16_t count)
+{
+    uint offset;
+    claim_state_machine(&led_matrix_program, serial_offset, &strip->pio, &strip->sm, &offset);
+    strip->pin = pin;
+    strip->pixels = pixels;
+    strip->count = count;
+    strip->dma_chan = -1;
+    strip->ready_us = time_us_32();
 
     // Inicia programa na máquina PIO obtida.
-    led_matrix_program_init(led_matrix_pio, sm, offset, pin, 800000.f);
+    led_matrix_program_init(strip->pio, strip->sm, offset, pin, WS2812B_BIT_FREQ);
 
     // Limpa buffer de pixels.
-    for (uint i = 0; i < LED_MATRIX_SIZE; ++i)
+    ws2812b_strip_clear(strip);
+}
+
+// Atribui uma cor RGB a um LED da fita.
+void ws2812b_strip_set_led(ws2812b_t *strip, uint index, uint8_t r, uint8_t g, uint8_t b)
+{
+    strip->pixels[index].R = r;
+    strip->pixels[index].G = g;
+    strip->pixels[index].B = b;
+}
+
+// Limpa o buffer de pixels da fita.
+void ws2812b_strip_clear(ws2812b_t *strip)
+{
+    for (uint i = 0; i < strip->count; ++i)
+        ws2812b_strip_set_led(strip, i, 0, 0, 0);
+}
+
+// Escreve os dados do buffer nos LEDs, bloqueando até o quadro sair e o reset terminar.
+void HOT_FUNC(ws2812b_strip_write)(ws2812b_t *strip)
+{
+    while ((strip->dma_chan >= 0 && dma_channel_is_busy(strip->dma_chan)) || !is_reset_done(strip->ready_us))
+        tight_loop_contents(); // Quadro anterior (DMA) ainda em envio ou no reset
+
+    // Escreve cada dado de 8-bits dos pixels em sequência no buffer da máquina PIO.
+    for (uint i = 0; i < strip->count; ++i)
+    {
+        pio_sm_put_blocking(strip->pio, strip->sm, strip->pixels[i].G);
+        pio_sm_put_blocking(strip->pio, strip->sm, strip->pixels[i].R);
+        pio_sm_put_blocking(strip->pio, strip->sm, strip->pixels[i].B);
+    }
+
+    // A FIFO cheia e a palavra em deslocamento ainda precisam sair antes do reset.
+    strip->ready_us = time_us_32() + (WS2812B_TX_FIFO_WORDS + 1) * WS2812B_WORD_US + WS2812B_RESET_US;
+    while (!is_reset_done(strip->ready_us))
+        tight_loop_contents();
+}
+
+// Reserva um canal DMA para alimentar a FIFO da PIO sem bloquear a CPU.
+void ws2812b_strip_dma_init(ws2812b_t *strip)
+{
+    strip->dma_chan = dma_claim_unused_channel(true); // Se nenhum canal estiver livre, panic!
+
+    dma_channel_config config = dma_channel_get_default_config(strip->dma_chan);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+    channel_config_set_read_increment(&config, true);
+    channel_config_set_write_increment(&config, false);
+    channel_config_set_dreq(&config, pio_get_dreq(strip->pio, strip->sm, true));
+
+    dma_channel_configure(strip->dma_chan, &config, &strip->pio->txf[strip->sm], NULL, strip->count * 3, false);
+}
+
+// Converte o buffer de pixels nas palavras enviadas à PIO (mesma ordem de ws2812b_strip_write).
+void ws2812b_strip_serialize(const ws2812b_t *strip, uint32_t *frame)
+{
+    for (uint i = 0; i < strip->count; ++i)
+    {
+        frame[3 * i] = strip->pixels[i].G;
+        frame[3 * i + 1] = strip->pixels[i].R;
+        frame[3 * i + 2] = strip->pixels[i].B;
+    }
+}
+
+// Inicia o envio de um quadro pré-serializado por DMA; pode ser chamada em interrupção.
+// Retorna false se o quadro anterior ainda estiver em envio ou no reset (o estado atual é mantido):
+// sem o reset, os LEDs receberiam os dois quadros como um só.
+bool HOT_FUNC(ws2812b_strip_write_frame_dma)(ws2812b_t *strip, const uint32_t *frame)
+{
+    if (strip->dma_chan < 0 || dma_channel_is_busy(strip->dma_chan) || !is_reset_done(strip->ready_us))
+        return false;
+
+    dma_channel_set_read_addr(strip->dma_chan, frame, true);
+    // Uma palavra a mais cobre a espera da máquina pela primeira palavra
+    strip->ready_us = time_us_32() + (strip->count * 3 + 1) * WS2812B_WORD_US + WS2812B_RESET_US;
+    return true;
+}
+
+// Recalcula o divisor da PIO para um novo clk_sys (observador de troca de clock).
+void ws2812b_strip_set_clock(ws2812b_t *strip, uint32_t sys_hz)
+{
+    pio_sm_set_clkdiv(strip->pio, strip->sm, led_matrix_program_clkdiv(sys_hz, WS2812B_BIT_FREQ));
+}
+
+static void parallel_setup(ws2812b_parallel_t *parallel, uint pin_base, uint8_t lanes, uint16_t count,
+                           uint32_t *planes, bool connect_pins)
+{
+    uint offset;
+    claim_state_machine(&led_matrix_parallel_program, parallel_offset, &parallel->pio, &parallel->sm, &offset);
+    parallel->pin_base = pin_base;
+    parallel->lanes = lanes > WS2812B_PARALLEL_MAX_LANES ? WS2812B_PARALLEL_MAX_LANES : lanes;
+    parallel->count = count;
+    parallel->planes = planes;
+    parallel->ready_us = time_us_32();
+
+    led_matrix_parallel_program_init(parallel->pio, parallel->sm, offset, pin_base, parallel->lanes,
+                                     WS2812B_BIT_FREQ, connect_pins);
+
+    parallel->dma_chan = dma_claim_unused_channel(true); // Se nenhum canal estiver livre, panic!
+    dma_channel_config config = dma_channel_get_default_config(parallel->dma_chan);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+    channel_config_set_read_increment(&config, true);
+    channel_config_set_write_increment(&config, false);
+    channel_config_set_dreq(&config, pio_get_dreq(parallel->pio, parallel->sm, true));
+    dma_channel_configure(parallel->dma_chan, &config, &parallel->pio->txf[parallel->sm], planes,
+                          WS2812B_PARALLEL_WORDS(count), false);
+}
+
+// Inicializa a saída paralela de até 8 fitas em pinos consecutivos a partir de pin_base.
+// Os buffers de pixels de cada fita são atribuídos em parallel->strips antes da transposição.
+void ws2812b_parallel_init(ws2812b_parallel_t *parallel, uint pin_base, uint8_t lanes, uint16_t count,
+                           uint32_t *planes)
+{
+    parallel_setup(parallel, pin_base, lanes, count, planes, true);
+}
+
+// Recalcula o divisor da PIO para um novo clk_sys (observador de troca de clock).
+void ws2812b_parallel_set_clock(ws2812b_parallel_t *parallel, uint32_t sys_hz)
+{
+    pio_sm_set_clkdiv(parallel->pio, parallel->sm, led_matrix_parallel_program_clkdiv(sys_hz, WS2812B_BIT_FREQ));
+}
+
+// Transpõe uma matriz de 8x8 bits: a entrada tem um byte por fita (fita 7 no byte mais
+// significativo de high, fita 0 no menos significativo de low) e a saída tem um byte por
+// bit-time, do bit mais significativo ao menos significativo, com a fita n no bit n.
+static inline void transpose8(uint32_t high, uint32_t low, uint8_t out[8])
+{
+    uint32_t t;
+    t = (high ^ (high >> 7)) & 0x00AA00AA;
+    high = high ^ t ^ (t << 7);
+    t = (low ^ (low >> 7)) & 0x00AA00AA;
+    low = low ^ t ^ (t << 7);
+    t = (high ^ (high >> 14)) & 0x0000CCCC;
+    high = high ^ t ^ (t << 14);
+    t = (low ^ (low >> 14)) & 0x0000CCCC;
+    low = low ^ t ^ (t << 14);
+    t = (high & 0xF0F0F0F0) | ((low >> 4) & 0x0F0F0F0F);
+    low = ((high << 4) & 0xF0F0F0F0) | (low & 0x0F0F0F0F);
+    high = t;
+
+    out[0] = high >> 24;
+    out[1] = high >> 16;
+    out[2] = high >> 8;
+    out[3] = high;
+    out[4] = low >> 24;
+    out[5] = low >> 16;
+    out[6] = low >> 8;
+    out[7] = low;
+}
+
+// Converte os buffers das fitas nos planos de bits enviados à PIO (G, R, B por LED, bit mais significativo primeiro).
+// Lê count pixels de cada uma das lanes fitas: uma fita mais curta precisa de um buffer completado com zeros.
+void ws2812b_parallel_transpose(ws2812b_parallel_t *parallel)
+{
+    uint8_t *out = (uint8_t *)parallel->planes; // Byte k da palavra = bit-time k (little-endian)
+    for (uint i = 0; i < parallel->count; i++)
+    {
+        uint8_t lane_bytes[3][WS2812B_PARALLEL_MAX_LANES] = {0};
+        for (uint lane = 0; lane < parallel->lanes; lane++)
+        {
+            const ws2812b_LED_t *pixel = &parallel->strips[lane][i];
+            lane_bytes[0][lane] = pixel->G;
+            lane_bytes[1][lane] = pixel->R;
+            lane_bytes[2][lane] = pixel->B;
+        }
+
+        for (uint color = 0; color < 3; color++, out += 8)
+        {
+            const uint8_t *b = lane_bytes[color];
+            uint32_t high = (uint32_t)b[7] << 24 | (uint32_t)b[6] << 16 | (uint32_t)b[5] << 8 | b[4];
+            uint32_t low = (uint32_t)b[3] << 24 | (uint32_t)b[2] << 16 | (uint32_t)b[1] << 8 | b[0];
+            transpose8(high, low, out);
+        }
+    }
+}
+
+// Inicia o envio dos planos de bits por DMA; retorna false se o envio anterior ou o reset não terminou.
+bool ws2812b_parallel_write_dma(ws2812b_parallel_t *parallel)
+{
+    if (ws2812b_parallel_is_busy(parallel))
+        return false;
+
+    dma_channel_set_read_addr(parallel->dma_chan, parallel->planes, true);
+    // Cada palavra carrega 4 bit-times; uma palavra a mais cobre a espera pela primeira
+    parallel->ready_us =
+        time_us_32() + (WS2812B_PARALLEL_WORDS(parallel->count) + 1) * WS2812B_PARALLEL_WORD_US + WS2812B_RESET_US;
+    return true;
+}
+
+bool ws2812b_parallel_is_busy(const ws2812b_parallel_t *parallel)
+{
+    return dma_channel_is_busy(parallel->dma_chan) || !is_reset_done(parallel->ready_us);
+}
+
+// Mede a transposição e o envio de um quadro paralelo de WS2812B_BENCHMARK_LANES fitas de
+// WS2812B_BENCHMARK_LEDS LEDs. Os pinos não são ligados à PIO: a máquina consome a FIFO no ritmo
+// real do protocolo sem acionar nada na placa. Ao final, a máquina e o canal DMA são liberados.
+void ws2812b_parallel_benchmark()
+{
+    static ws2812b_LED_t pixels[WS2812B_BENCHMARK_LEDS];
+    static uint32_t planes[WS2812B_PARALLEL_WORDS(WS2812B_BENCHMARK_LEDS)];
+    ws2812b_parallel_t parallel;
+
+    parallel_setup(&parallel, WS2812B_BENCHMARK_PIN_BASE, WS2812B_BENCHMARK_LANES, WS2812B_BENCHMARK_LEDS, planes,
+                   false);
+    for (uint i = 0; i < WS2812B_BENCHMARK_LEDS; i++)
+        pixels[i] = (ws2812b_LED_t){.G = i, .R = i >> 1, .B = ~i};
+    for (uint lane = 0; lane < WS2812B_BENCHMARK_LANES; lane++)
+        parallel.strips[lane] = pixels; // O custo não depende do conteúdo
+
+    uint32_t transpose_total_us = 0, transpose_worst_us = 0;
+    uint32_t send_total_us = 0, send_worst_us = 0;
+    for (uint frame = 0; frame < WS2812B_BENCHMARK_FRAMES; frame++)
     {
-        led_matrix[i].R = 0;
-        led_matrix[i].G = 0;
-        led_matrix[i].B = 0;
+        while (ws2812b_parallel_is_busy(&parallel))
+            tight_loop_contents();
+
+        uint32_t irq_state = save_and_disable_interrupts();
+        uint32_t start_us = time_us_32();
+        ws2812b_parallel_transpose(&parallel);
+        uint32_t transpose_us = time_us_32() - start_us;
+
+        // Do disparo do DMA até a máquina tirar a última palavra da FIFO (falta só a palavra no OSR)
+        start_us = time_us_32();
+        ws2812b_parallel_write_dma(&parallel);
+        while (dma_channel_is_busy(parallel.dma_chan) || !pio_sm_is_tx_fifo_empty(parallel.pio, parallel.sm))
+            tight_loop_contents();
+        uint32_t send_us = time_us_32() - start_us;
+        restore_interrupts(irq_state);
+
+        transpose_total_us += transpose_us;
+        transpose_worst_us = MAX(transpose_worst_us, transpose_us);
+        send_total_us += send_us;
+        send_worst_us = MAX(send_worst_us, send_us);
     }
+
+    while (ws2812b_parallel_is_busy(&parallel))
+        tight_loop_contents();
+    pio_sm_set_enabled(parallel.pio, parallel.sm, false);
+    pio_sm_unclaim(parallel.pio, parallel.sm);
+    dma_channel_unclaim(parallel.dma_chan);
+
+    printf("ws2812b_paralelo;fitas;%u;leds_por_fita;%u;clk_mhz;%lu\n", WS2812B_BENCHMARK_LANES,
+           WS2812B_BENCHMARK_LEDS, (unsigned long)(clock_get_hz(clk_sys) / 1000000));
+    printf("etapa;medio_us;pior_us\n");
+    printf("transposicao;%lu;%lu\n", (unsigned long)(transpose_total_us / WS2812B_BENCHMARK_FRAMES),
+           (unsigned long)transpose_worst_us);
+    printf("envio;%lu;%lu\n", (unsigned long)(send_total_us / WS2812B_BENCHMARK_FRAMES),
+           (unsigned long)send_worst_us);
+    printf("envio_esperado_us;%u\n", WS2812B_PARALLEL_WORDS(WS2812B_BENCHMARK_LEDS) * WS2812B_PARALLEL_WORD_US);
+}
+
+// Inicializa a máquina PIO para controle da matriz de LEDs.
+void ws2812b_init(uint pin)
+{
+    ws2812b_strip_init(&ws2812b_matrix, pin, led_matrix, LED_MATRIX_SIZE);
 }
 
 // Atribui uma cor RGB a um LED.
 void ws2812b_set_led(const uint index, const uint8_t r, const uint8_t g, const uint8_t b)
 {
-    led_matrix[index].R = r;
-    led_matrix[index].G = g;
-    led_matrix[index].B = b;
+    ws2812b_strip_set_led(&ws2812b_matrix, index, r, g, b);
 }
 
 // Limpa o buffer de pixels.
 void ws2812b_clear()
 {
-    for (uint i = 0; i < LED_MATRIX_SIZE; ++i)
-        ws2812b_set_led(i, 0, 0, 0);
+    ws2812b_strip_clear(&ws2812b_matrix);
 }
 
 // Escreve os dados do buffer nos LEDs.
-void ws2812b_write()
+void HOT_FUNC(ws2812b_write)()
 {
-    // Escreve cada dado de 8-bits dos pixels em sequência no buffer da máquina PIO.
-    for (uint i = 0; i < LED_MATRIX_SIZE; ++i)
-    {
-        pio_sm_put_blocking(led_matrix_pio, sm, led_matrix[i].G);
-        pio_sm_put_blocking(led_matrix_pio, sm, led_matrix[i].R);
-        pio_sm_put_blocking(led_matrix_pio, sm, led_matrix[i].B);
-    }
-    sleep_us(100); // Espera 100us, sinal de RESET do datasheet.
+    ws2812b_strip_write(&ws2812b_matrix);
 }
 
 // Desenha um ponto na matriz de LEDs.
 void ws2812b_draw_point(uint8_t point_index, const int color[3]) {
 
     ws2812b_set_led(point_index, color[0], color[1], color[2]);
-    printf("Desenhando ponto %d\n", point_index);
-    printf("Cor: %d %d %d\n", color[0], color[1], color[2]);
+    LOG4(LOG_MATRIX_POINT, point_index, color[0], color[1], color[2]);
 
     // Atualiza a matriz de LEDs.
     ws2812b_write();
 }
 
 // Preenche uma coluna da matriz de LEDs com uma cor específica.
+// Mantém a numeração original desta função: a coluna 0 é a da direita, onde começa a fiação
+// (no canvas, x = 0 é a coluna da esquerda).
 void ws2812b_fill_column(uint8_t column, const int color[3]) {
     if (column >= LED_MATRIX_COL) return;
 
-    // Para uma matriz 5x5, mapeamento das posições na vertical:
-    for (int row = 0; row < LED_MATRIX_ROW; row++) {
-        int led_index;
-
-        // Mapeamento correto para padrão snake
-        if (row % 2 == 0) {
-            // Linha par: esquerda para direita
-            led_index = row * LED_MATRIX_ROW + column;
-        } else {
-            // Linha ímpar: direita para esquerda
-            led_index = row * LED_MATRIX_ROW + (LED_MATRIX_ROW - 1 - column);
-        }
+    for (uint row = 0; row < LED_MATRIX_ROW; row++)
+        ws2812b_set_led(ws2812b_index(LED_MATRIX_COL - 1 - column, row), color[0], color[1], color[2]);
+}
 
-        ws2812b_set_led(led_index, color[0], color[1], color[2]);
-    }
+void ws2812b_dma_init()
+{
+    ws2812b_strip_dma_init(&ws2812b_matrix);
+}
+
+void ws2812b_serialize(uint32_t frame[LED_MATRIX_FRAME_WORDS])
+{
+    ws2812b_strip_serialize(&ws2812b_matrix, frame);
+}
+
+bool HOT_FUNC(ws2812b_write_frame_dma)(const uint32_t frame[LED_MATRIX_FRAME_WORDS])
+{
+    return ws2812b_strip_write_frame_dma(&ws2812b_matrix, frame);
+}
+
+void ws2812b_set_clock(uint32_t sys_hz)
+{
+    ws2812b_strip_set_clock(&ws2812b_matrix, sys_hz);
 }
@@ -5,11 +5,21 @@
 #include <stdio.h>
 #include "hardware/pio.h"
 #include "pico/stdlib.h"
+#include "ws2812b_repeat.h"
 
 
 #define LED_MATRIX_ROW 5
 #define LED_MATRIX_COL 5
 #define LED_MATRIX_SIZE (LED_MATRIX_ROW * LED_MATRIX_COL) // 5x5 = 25 LEDs
+#define LED_MATRIX_FRAME_WORDS (LED_MATRIX_SIZE * 3)      // Palavras enviadas à FIFO da PIO por quadro
+
+// Índice do LED na posição (x, y), com (0, 0) no canto superior esquerdo.
+// A fiação é serpentina a partir do canto inferior direito: linhas físicas pares da direita
+// para a esquerda, ímpares da esquerda para a direita. Expressão constante.
+#define WS2812B_ROW_FROM_BOTTOM(y) (LED_MATRIX_ROW - 1 - (y))
+#define WS2812B_INDEX(x, y)                                                                                     \
+    (WS2812B_ROW_FROM_BOTTOM(y) * LED_MATRIX_COL +                                                             \
+     (WS2812B_ROW_FROM_BOTTOM(y) % 2 == 0 ? LED_MATRIX_COL - 1 - (x) : (x)))
 
 
 // Tipos de dados.
@@ -20,15 +30,83 @@ struct pixel_t
 typedef struct pixel_t pixel_t;
 typedef pixel_t ws2812b_LED_t; // Mudança de nome de "struct pixel_t" para "ws2812bLED_t" por clareza.
 
+// Fita de LEDs em uma máquina PIO própria, com buffer de pixels fornecido por quem a cria.
+typedef struct ws2812b_t
+{
+    PIO pio;               // Bloco PIO da máquina
+    uint sm;               // Número da máquina state machine
+    uint pin;              // Pino de dados
+    ws2812b_LED_t *pixels; // Buffer de pixels
+    uint16_t count;        // Número de LEDs
+    int dma_chan;          // Canal DMA (-1 até ws2812b_strip_dma_init)
+    uint32_t ready_us;     // Fim do quadro anterior mais o reset: antes disso, um novo quadro se emendaria
+} ws2812b_t;
+
+#define WS2812B_BIT_FREQ 800000.f // Frequência de bits do protocolo
+#define WS2812B_WORD_US 10        // Palavra de 8 bits da máquina serial a 800 kHz
+#define WS2812B_TX_FIFO_WORDS 8   // FIFO de transmissão unida
+#define WS2812B_RESET_US 100      // Linha em nível baixo entre quadros (datasheet: ao menos 50 us)
+
+#define WS2812B_PARALLEL_MAX_LANES 8 // Fitas acionadas por uma única máquina PIO
+#define WS2812B_PARALLEL_WORDS(count) ((count) * 6) // Palavras de planos de bits: 24 bit-times / 4 por palavra
+#define WS2812B_PARALLEL_WORD_US 5                  // 4 bit-times de 1,25 us por palavra
+
+#define WS2812B_BENCHMARK_LANES 8     // Fitas do quadro medido por ws2812b_parallel_benchmark
+#define WS2812B_BENCHMARK_LEDS 300    // LEDs por fita do quadro medido
+#define WS2812B_BENCHMARK_FRAMES 10   // Quadros medidos
+#define WS2812B_BENCHMARK_PIN_BASE 8  // GPIO 8 a 15: nenhum deles usa função PIO na placa
+
+// Até 8 fitas em pinos consecutivos, transmitidas ao mesmo tempo: o tempo de envio é o de uma única fita.
+typedef struct ws2812b_parallel_t
+{
+    PIO pio;
+    uint sm;
+    uint pin_base;                                      // Pino da fita 0; a fita n usa pin_base + n
+    uint8_t lanes;                                      // Número de fitas
+    uint16_t count;                                     // LEDs enviados por fita (a mais longa)
+    ws2812b_LED_t *strips[WS2812B_PARALLEL_MAX_LANES];  // count pixels cada; fitas curtas completadas com zeros
+    uint32_t *planes;                                   // WS2812B_PARALLEL_WORDS(count) palavras
+    int dma_chan;
+    uint32_t ready_us;                                  // Fim do quadro anterior mais o reset
+} ws2812b_parallel_t;
+
 extern ws2812b_LED_t led_matrix[LED_MATRIX_SIZE]; // Declaração do buffer de pixels que formam a matriz.
-extern PIO led_matrix_pio;                     // Ponteiro para a máquina PIO.
-extern uint sm;                        // Número da máquina state machine.
+extern ws2812b_t ws2812b_matrix;                  // Instância da matriz 5x5 usada pelas funções ws2812b_*.
+extern const uint16_t ws2812b_index_map[LED_MATRIX_ROW][LED_MATRIX_COL]; // Coordenada -> índice, gerado na compilação.
+
+// Índice do LED na posição (x, y); a posição deve estar dentro da matriz.
+static inline uint16_t ws2812b_index(uint x, uint y)
+{
+    return ws2812b_index_map[y][x];
+}
+
+void ws2812b_strip_init(ws2812b_t *strip, uint pin, ws2812b_LED_t *pixels, uint16_t count);
+void ws2812b_strip_set_led(ws2812b_t *strip, uint index, uint8_t r, uint8_t g, uint8_t b);
+void ws2812b_strip_clear(ws2812b_t *strip);
+void ws2812b_strip_write(ws2812b_t *strip);
+void ws2812b_strip_dma_init(ws2812b_t *strip);
+void ws2812b_strip_serialize(const ws2812b_t *strip, uint32_t *frame);
+bool ws2812b_strip_write_frame_dma(ws2812b_t *strip, const uint32_t *frame);
+void ws2812b_strip_set_clock(ws2812b_t *strip, uint32_t sys_hz);
+
+void ws2812b_parallel_init(ws2812b_parallel_t *parallel, uint pin_base, uint8_t lanes, uint16_t count,
+                           uint32_t *planes);
+void ws2812b_parallel_transpose(ws2812b_parallel_t *parallel);
+bool ws2812b_parallel_write_dma(ws2812b_parallel_t *parallel);
+bool ws2812b_parallel_is_busy(const ws2812b_parallel_t *parallel);
+void ws2812b_parallel_set_clock(ws2812b_parallel_t *parallel, uint32_t sys_hz);
+void ws2812b_parallel_benchmark();
 
+// Funções da matriz 5x5 (instância ws2812b_matrix).
 void ws2812b_init(uint pin);
 void ws2812b_set_led(const uint index, const uint8_t r, const uint8_t g, const uint8_t b);
 void ws2812b_clear();
 void ws2812b_write();
 void ws2812b_draw_point(uint8_t number_index, const int color[3]);
 void ws2812b_fill_column(uint8_t column, const int color[3]);
+void ws2812b_dma_init();
+void ws2812b_serialize(uint32_t frame[LED_MATRIX_FRAME_WORDS]);
+bool ws2812b_write_frame_dma(const uint32_t frame[LED_MATRIX_FRAME_WORDS]);
+void ws2812b_set_clock(uint32_t sys_hz);
 
 #endif // WS2812B_H
@@ -0,0 +1,79 @@
+#ifndef WS2812B_REPEAT_H
+#define WS2812B_REPEAT_H
+
+// Repetição em tempo de compilação usada para gerar o mapa de índices da matriz.
+// WS2812B_REPEAT_Y(n, M, arg) expande M(0, arg) M(1, arg) ... M(n-1, arg); idem para _X.
+// Há uma família por eixo porque o pré-processador não reexpande uma macro dentro de si mesma.
+// n precisa ser um literal inteiro de 1 a 32 (como LED_MATRIX_ROW e LED_MATRIX_COL).
+
+#define WS2812B_REPEAT_Y(n, M, arg) WS2812B_REPEAT_Y_EXPAND(n, M, arg)
+#define WS2812B_REPEAT_Y_EXPAND(n, M, arg) WS2812B_REPEAT_Y_##n(M, arg)
+#define WS2812B_REPEAT_Y_1(M, arg) M(0, arg)
+#define WS2812B_REPEAT_Y_2(M, arg) WS2812B_REPEAT_Y_1(M, arg) M(1, arg)
+#define WS2812B_REPEAT_Y_3(M, arg) WS2812B_REPEAT_Y_2(M, arg) M(2, arg)
+#define WS2812B_REPEAT_Y_4(M, arg) WS2812B_REPEAT_Y_3(M, arg) M(3, arg)
+#define WS2812B_REPEAT_Y_5(M, arg) WS2812B_REPEAT_Y_4(M, arg) M(4, arg)
+#define WS2812B_REPEAT_Y_6(M, arg) WS2812B_REPEAT_Y_5(M, arg) M(5, arg)
+#define WS2812B_REPEAT_Y_7(M, arg) WS2812B_REPEAT_Y_6(M, arg) M(6, arg)
+#define WS2812B_REPEAT_Y_8(M, arg) WS2812B_REPEAT_Y_7(M, arg) M(7, arg)
+#define WS2812B_REPEAT_Y_9(M, arg) WS2812B_REPEAT_Y_8(M, arg) M(8, arg)
+#define WS2812B_REPEAT_Y_10(M, arg) WS2812B_REPEAT_Y_9(M, arg) M(9, arg)
+#define WS2812B_REPEAT_Y_11(M, arg) WS2812B_REPEAT_Y_10(M, arg) M(10, arg)
+#define WS2812B_REPEAT_Y_12(M, arg) WS2812B_REPEAT_Y_11(M, arg) M(11, arg)
+#define WS2812B_REPEAT_Y_13(M, arg) WS2812B_REPEAT_Y_12(M, arg) M(12, arg)
+#define WS2812B_REPEAT_Y_14(M, arg) WS2812B_REPEAT_Y_13(M, arg) M(13, arg)
+#define WS2812B_REPEAT_Y_15(M, arg) WS2812B_REPEAT_Y_14(M, arg) M(14, arg)
+#define WS2812B_REPEAT_Y_16(M, arg) WS2812B_REPEAT_Y_15(M, arg) M(15, arg)
+#define WS2812B_REPEAT_Y_17(M, arg) WS2812B_REPEAT_Y_16(M, arg) M(16, arg)
+#define WS2812B_REPEAT_Y_18(M, arg) WS2812B_REPEAT_Y_17(M, arg) M(17, arg)
+#define WS2812B_REPEAT_Y_19(M, arg) WS2812B_REPEAT_Y_18(M, arg) M(18, arg)
+#define WS2812B_REPEAT_Y_20(M, arg) WS2812B_REPEAT_Y_19(M, arg) M(19, arg)
+#define WS2812B_REPEAT_Y_21(M, arg) WS2812B_REPEAT_Y_20(M, arg) M(20, arg)
+#define WS2812B_REPEAT_Y_22(M, arg) WS2812B_REPEAT_Y_21(M, arg) M(21, arg)
+#define WS2812B_REPEAT_Y_23(M, arg) WS2812B_REPEAT_Y_22(M, arg) M(22, arg)
+#define WS2812B_REPEAT_Y_24(M, arg) WS2812B_REPEAT_Y_23(M, arg) M(23, arg)
+#define WS2812B_REPEAT_Y_25(M, arg) WS2812B_REPEAT_Y_24(M, arg) M(24, arg)
+#define WS2812B_REPEAT_Y_26(M, arg) WS2812B_REPEAT_Y_25(M, arg) M(25, arg)
+#define WS2812B_REPEAT_Y_27(M, arg) WS2812B_REPEAT_Y_26(M, arg) M(26, arg)
+#define WS2812B_REPEAT_Y_28(M, arg) WS2812B_REPEAT_Y_27(M, arg) M(27, arg)
+#define WS2812B_REPEAT_Y_29(M, arg) WS2812B_REPEAT_Y_28(M, arg) M(28, arg)
+#define WS2812B_REPEAT_Y_30(M, arg) WS2812B_REPEAT_Y_29(M, arg) M(29, arg)
+#define WS2812B_REPEAT_Y_31(M, arg) WS2812B_REPEAT_Y_30(M, arg) M(30, arg)
+#define WS2812B_REPEAT_Y_32(M, arg) WS2812B_REPEAT_Y_31(M, arg) M(31, arg)
+
+#define WS2812B_REPEAT_X(n, M, arg) WS2812B_REPEAT_X_EXPAND(n, M, arg)
+#define WS2812B_REPEAT_X_EXPAND(n, M, arg) WS2812B_REPEAT_X_##n(M, arg)
+#define WS2812B_REPEAT_X_1(M, arg) M(0, arg)
+#define WS2812B_REPEAT_X_2(M, arg) WS2812B_REPEAT_X_1(M, arg) M(1, arg)
+#define WS2812B_REPEAT_X_3(M, arg) WS2812B_REPEAT_X_2(M, arg) M(2, arg)
+#define WS2812B_REPEAT_X_4(M, arg) WS2812B_REPEAT_X_3(M, arg) M(3, arg)
+#define WS2812B_REPEAT_X_5(M, arg) WS2812B_REPEAT_X_4(M, arg) M(4, arg)
+#define WS2812B_REPEAT_X_6(M, arg) WS2812B_REPEAT_X_5(M, arg) M(5, arg)
+#define WS2812B_REPEAT_X_7(M, arg) WS2812B_REPEAT_X_6(M, arg) M(6, arg)
+#define WS2812B_REPEAT_X_8(M, arg) WS2812B_REPEAT_X_7(M, arg) M(7, arg)
+#define WS2812B_REPEAT_X_9(M, arg) WS2812B_REPEAT_X_8(M, arg) M(8, arg)
+#define WS2812B_REPEAT_X_10(M, arg) WS2812B_REPEAT_X_9(M, arg) M(9, arg)
+#define WS2812B_REPEAT_X_11(M, arg) WS2812B_REPEAT_X_10(M, arg) M(10, arg)
+#define WS2812B_REPEAT_X_12(M, arg) WS2812B_REPEAT_X_11(M, arg) M(11, arg)
+#define WS2812B_REPEAT_X_13(M, arg) WS2812B_REPEAT_X_12(M, arg) M(12, arg)
+#define WS2812B_REPEAT_X_14(M, arg) WS2812B_REPEAT_X_13(M, arg) M(13, arg)
+#define WS2812B_REPEAT_X_15(M, arg) WS2812B_REPEAT_X_14(M, arg) M(14, arg)
+#define WS2812B_REPEAT_X_16(M, arg) WS2812B_REPEAT_X_15(M, arg) M(15, arg)
+#define WS2812B_REPEAT_X_17(M, arg) WS2812B_REPEAT_X_16(M, arg) M(16, arg)
+#define WS2812B_REPEAT_X_18(M, arg) WS2812B_REPEAT_X_17(M, arg) M(17, arg)
+#define WS2812B_REPEAT_X_19(M, arg) WS2812B_REPEAT_X_18(M, arg) M(18, arg)
+#define WS2812B_REPEAT_X_20(M, arg) WS2812B_REPEAT_X_19(M, arg) M(19, arg)
+#define WS2812B_REPEAT_X_21(M, arg) WS2812B_REPEAT_X_20(M, arg) M(20, arg)
+#define WS2812B_REPEAT_X_22(M, arg) WS2812B_REPEAT_X_21(M, arg) M(21, arg)
+#define WS2812B_REPEAT_X_23(M, arg) WS2812B_REPEAT_X_22(M, arg) M(22, arg)
+#define WS2812B_REPEAT_X_24(M, arg) WS2812B_REPEAT_X_23(M, arg) M(23, arg)
+#define WS2812B_REPEAT_X_25(M, arg) WS2812B_REPEAT_X_24(M, arg) M(24, arg)
+#define WS2812B_REPEAT_X_26(M, arg) WS2812B_REPEAT_X_25(M, arg) M(25, arg)
+#define WS2812B_REPEAT_X_27(M, arg) WS2812B_REPEAT_X_26(M, arg) M(26, arg)
+#define WS2812B_REPEAT_X_28(M, arg) WS2812B_REPEAT_X_27(M, arg) M(27, arg)
+#define WS2812B_REPEAT_X_29(M, arg) WS2812B_REPEAT_X_28(M, arg) M(28, arg)
+#define WS2812B_REPEAT_X_30(M, arg) WS2812B_REPEAT_X_29(M, arg) M(29, arg)
+#define WS2812B_REPEAT_X_31(M, arg) WS2812B_REPEAT_X_30(M, arg) M(30, arg)
+#define WS2812B_REPEAT_X_32(M, arg) WS2812B_REPEAT_X_31(M, arg) M(31, arg)
+
+#endif // WS2812B_REPEAT_H
@@ -1,16 +1,38 @@
 #include <stdio.h>
+#include <string.h>
 
 #include "pico/stdlib.h"
 #include "pico/bootrom.h"
 #include "hardware/gpio.h"
 #include "hardware/i2c.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "hardware/structs/timer.h"
 
 #include "lib/ssd1306/ssd1306.h"
 #include "lib/ssd1306/display.h"
+#include "lib/ssd1306/ui.h"
 #include "lib/led/led.h"
 #include "lib/button/button.h"
 #include "lib/ws2812b/ws2812b.h"
+#include "lib/ws2812b/animation.h"
+#include "lib/ws2812b/canvas.h"
 #include "lib/buzzer/buzzer.h"
+#include "lib/actuation/actuation.h"
+#include "lib/monitor/deadline_monitor.h"
+#include "lib/timebase/timebase.h"
+#include "lib/log/log.h"
+#include "lib/profiler/stack_profiler.h"
+#include "lib/profiler/xip_profiler.h"
+#include "lib/power/power.h"
+#include "lib/coord/coord.h"
+#include "lib/detector/detector.h"
+#include "lib/cyclelog/cyclelog.h"
+#include "lib/status/status.h"
+#include "lib/hal/hal_benchmark.h"
+#include "lib/webster/webster.h"
+#include "lib/webster/webster_benchmark.h"
+#include "src/task_config.h"
 
 #include "FreeRTOS.h"
 #include "FreeRTOSConfig.h"
@@ -18,172 +40,797 @@
 
 #define MATRIX_LED_PIN 7
 #define TRAFFIC_LIGHT_DELAY_MS 2000
+#ifdef ACTUATED
+#define IS_ACTUATED true
+#else
+#define IS_ACTUATED false
+#endif
+#ifdef COORDINATION
+#define IS_COORDINATED true
+#else
+#define IS_COORDINATED false
+#endif
+#define COORD_CYCLE_MS (3 * TRAFFIC_LIGHT_DELAY_MS) // Ciclo coordenado: verde, amarelo e vermelho
+#ifdef ADAPTIVE_TIMING
+#define IS_ADAPTIVE true
+#else
+#define IS_ADAPTIVE false
+#endif
+#define ADAPTIVE_PHASE_WALK 0                       // Fase do plano adaptativo: verde de pedestres e amarelo
+#define ADAPTIVE_PHASE_VEHICLE 1                    // Fase do plano adaptativo: vermelho (veículos passam)
+#define ADAPTIVE_APPROACH_PEDESTRIAN 0              // Aproximação das chamadas de pedestre
+#define ADAPTIVE_APPROACH_VEHICLE 1                 // Primeiro laço detector; os demais canais seguem
+#define ADAPTIVE_APPROACHES (1 + DETECTOR_CHANNELS) // Pedestres e um laço detector por canal
+#define ADAPTIVE_STARTUP_LOST_MS 2000               // Tempo perdido na partida dos veículos
+#define ADAPTIVE_PEDESTRIAN_SATURATION_PER_H 3600   // Chamadas de pedestre atendidas por hora de verde
+#define ADAPTIVE_VEHICLE_SATURATION_PER_H 1800      // Veículos por hora de verde em cada faixa
+#define ADAPTIVE_MAX_CYCLE_MS 60000
+#define LONG_PRESS_MS 1000 // Pressão longa no botão A alterna o modo noturno no modo atuado
+#define MONITOR_PERIOD_MS 100        // Período de verificação dos prazos
+#define MONITOR_REPORT_MS 30000      // Intervalo entre relatórios de prazos
+#define WATCHDOG_TIMEOUT_MS 2000     // Timeout do watchdog de hardware
+#define OUTPUT_IDLE_TIMEOUT_MS 1000  // Espera máxima das saídas por uma fronteira de fase
+#define LOG_DRAIN_PERIOD_MS 20       // Período de envio do log binário pela USB
+#define HOST_COMMAND_MAX 32          // Linha de comando recebida do host pela USB
+
+#define MATRIX_NIGHT_ON_FRAME 3  // Quadro do pisca noturno aceso
+#define MATRIX_NIGHT_OFF_FRAME 4 // Quadro do pisca noturno apagado
+#define MATRIX_FRAME_COUNT 5
+#define MATRIX_BOUNDARY_GUARD_US 2000 // Sem quadros da animação perto de uma fronteira agendada
+#define MATRIX_NIGHT_FADE_MS 200      // Apagamento suave da matriz no início da metade apagada do pisca
+
+// Notificações da tarefa do display
+#define DISPLAY_NOTIFY_PREPARE (1u << 0) // Nova fase publicada: desenhar no buffer
+#define DISPLAY_NOTIFY_COMMIT (1u << 1)  // Fronteira alcançada: enviar o buffer
+
+// Notificação da tarefa de relatórios
+#define REPORT_NOTIFY_FAULT 1 // Entrada no modo de segurança: apenas o relatório de prazos
+
+// Identificadores das tarefas (índices da tabela de tarefas): primeiro as do plano de tarefas
+#define TASK_PLAN_ID(id, function, name, stack, period_ms, max_interval_ms, wcet_us, deadline_ms, blocking_us, \
+                     is_critical)                                                                            \
+    id,
+#define TASK_PLAN_COUNT(id, function, name, stack, period_ms, max_interval_ms, wcet_us, deadline_ms, blocking_us, \
+                        is_critical)                                                                            \
+    +1
+#define PLANNED_TASK_COUNT (0 TASK_TABLE(TASK_PLAN_COUNT))
+
+typedef enum
+{
+    TASK_TABLE(TASK_PLAN_ID)
+#ifdef STACK_PROFILING
+    TASK_STACK_PROFILER,
+#endif
+    TASK_COUNT,
+} task_id_t;
+
+typedef struct task_descriptor_t
+{
+    TaskFunction_t function;           // Função da tarefa
+    const char *name;                  // Nome da tarefa
+    const char *stack_setting;         // Constante do tamanho da pilha em src/task_config.h
+    configSTACK_DEPTH_TYPE stack_size; // Tamanho da pilha (em palavras)
+    uint32_t period_ms;                // Menor intervalo entre liberações (prioridade por taxa monotônica)
+    uint32_t max_interval_ms;          // Maior intervalo entre liberações, declarado ao monitor de prazos
+    uint32_t wcet_us;                  // Orçamento de execução de um job
+    uint32_t deadline_ms;              // Tempo máximo de resposta (0: não monitorada)
+    bool is_critical;                  // Perda de prazo aciona o modo de segurança
+} task_descriptor_t;
 
 typedef struct traffic_light_config_t
 {
     //Estados do semáforo: [0]Verde, [1]Amarelo, [2]Vermelho
     int rgb_led_state[3][3];     // Valores do LED RGB (R, G, B) para cada estado do semáforo.
-    int matrix_led_indexes[3];   // Índices dos LEDs na matriz
-    int matrix_led_colors[3][3]; // Cores dos LEDs (R, G, B)
+    int matrix_led_positions[3][2]; // Posições (x, y) dos LEDs na matriz, (0, 0) no canto superior esquerdo
+    int matrix_led_colors[3][3]; // Cores lineares dos LEDs (R, G, B), antes da correção gama
     bool is_night_mode;          // Modo noturno
+    bool is_actuated_mode;       // Modo atuado por chamadas de pedestre e detector veicular
+    bool is_coordinated_mode;    // Ciclo de tempo fixo travado ao controlador a montante (onda verde)
+    bool is_adaptive_mode;       // Ciclo e verdes recalculados a cada ciclo pela demanda medida (Webster)
+    bool is_fault_mode;          // Modo de segurança (amarelo piscante) após perda de prazo do controle
     int buzzer_frequency[3];     // Frequência do buzzer
     int buzzer_active_time[3];   // Tempo do buzzer
     int buzzer_inactive_time[3]; // Tempo do buzzer inativo
 } traffic_light_config_t;
 
 void gpio_irq_handler(uint gpio, uint32_t events);
+void gpio_raw_irq_handler();
+UBaseType_t rate_monotonic_priority(int id);
+uint32_t task_exec_time_us();
+void task_delay_ms(task_id_t task_id, uint32_t ms);
+uint32_t task_wait_notify(task_id_t task_id, uint32_t timeout_ms);
+timebase_phase_t current_phase();
+void publish_phase();
+void schedule_phase(uint64_t boundary_us);
+void run_coordinated_cycle();
+void adaptive_init();
+void adaptive_count(uint8_t approach);
+bool adaptive_wait_boundary(uint64_t boundary_us);
+void run_adaptive_cycle();
+void init_outputs();
+bool commit_rgb_led(const timebase_phase_t *phase);
+bool commit_led_matrix(const timebase_phase_t *phase);
+bool retry_matrix_commit();
+const anim_sequence_t *matrix_sequence_for(int kind);
+uint32_t matrix_sequence_offset_ms(int kind);
+bool commit_buzzer(const timebase_phase_t *phase);
+void prepare_display(const timebase_phase_t *phase);
+bool commit_display(const timebase_phase_t *phase);
+void prepare_cyclelog(const timebase_phase_t *phase);
+uint32_t total_deadline_misses();
+void status_phase_source(status_phase_t *status);
+void status_outputs_source(status_outputs_t *status);
+void status_stats_source(status_stats_t *status);
+void toggle_night_mode();
+void apply_power_profile();
+void on_clock_change(uint32_t sys_hz);
 void vModeToggleTask();
-void vLedMatrixTask();
-void vRGBLedTask();
 void vDisplayTask();
+void vLedMatrixTask();
 void vTrafficLightControlTask();
 void vBuzzerTask();
+void vDeadlineMonitorTask();
+void vStackProfilerTask();
+void vLogDrainTask();
+void vDetectorTask();
+void vCycleLogTask();
+void vReportTask();
+void run_host_command(const char *line);
+void on_detector_edge(void *context, uint8_t channel, bool occupied, uint64_t time_us);
 
 /// Configuração do semáforo
 volatile traffic_light_config_t tl_settings = {
     .rgb_led_state = {{0, 1, 0}, {1, 1, 0}, {1, 0, 0}},
-    .matrix_led_indexes = {17, 12, 7},
-    .matrix_led_colors = {{0, 8, 0}, {4, 8, 0}, {8, 0, 0}},
+    .matrix_led_positions = {{2, 1}, {2, 2}, {2, 3}},
+    .matrix_led_colors = {{0, 255, 0}, {186, 255, 0}, {255, 0, 0}},
     .is_night_mode = false,
+    .is_actuated_mode = IS_ACTUATED && !IS_COORDINATED && !IS_ADAPTIVE, // Coordenação e plano adaptativo prevalecem
+    .is_coordinated_mode = IS_COORDINATED,
+    .is_adaptive_mode = IS_ADAPTIVE,
+    .is_fault_mode = false,
     .buzzer_frequency = {220, 1950, 450},     // Frequências do buzzer para cada estado
     .buzzer_active_time = {1000, 250, 500},    // Tempo do buzzer ativo para cada estado
     .buzzer_inactive_time = {1000, 250, 1500}, // Tempo do buzzer inativo para cada estado
 };
 volatile int light_state = 2; // Estado do semáforo (0: Verde, 1: Amarelo, 2: Vermelho)
 
+/// Coordenação em onda verde
+const coord_config_t coord_config = {
+    .cycle_length_us = COORD_CYCLE_MS * 1000,
+    .offset_us = COORDINATION_OFFSET_MS * 1000,
+    .link_delay_us = COORD_LINK_DELAY_US,
+    .kp_q8 = 128, // Metade do erro de fase corrigida a cada ciclo
+    .ki_q8 = 32,
+    .step_threshold_us = COORD_CYCLE_MS * 100, // 10% do ciclo
+    .max_slew_us = COORD_CYCLE_MS * 10,        // 1% do ciclo
+    .holdover_cycles = 5,
+};
+
+/// Tempos do modo atuado
+const actuation_timing_t actuation_timing = {
+    .walk_ms = TRAFFIC_LIGHT_DELAY_MS,
+    .clearance_ms = TRAFFIC_LIGHT_DELAY_MS,
+    .min_vehicle_green_ms = 5000,
+    .vehicle_gap_ms = 1500,
+    .max_vehicle_green_ms = 15000,
+};
+
+/// Plano de tempos adaptativo
+webster_t adaptive_optimizer;
+volatile uint16_t adaptive_counts[ADAPTIVE_APPROACHES]; // Demanda desde o último plano
+uint64_t adaptive_cycle_start_us = 0;   // Início do próximo ciclo (no passado: recomeçar agora)
+uint64_t adaptive_counts_start_us = 0;  // Início da janela das contagens
+
+TaskHandle_t task_handles[TASK_COUNT]; // Handles das tarefas criadas a partir da tabela
+volatile uint32_t task_switched_in_us;  // Instante em que a tarefa corrente assumiu a CPU (traceTASK_SWITCHED_IN)
+
+/// Quadros da matriz e valores do LED RGB pré-calculados para cada fase
+uint32_t matrix_frames[MATRIX_FRAME_COUNT][LED_MATRIX_FRAME_WORDS];
+uint32_t matrix_animation_frames[2][LED_MATRIX_FRAME_WORDS]; // Buffers duplos da animação
+volatile int matrix_kind = 2;          // Quadro/sequência da fase efetivada
+volatile uint64_t matrix_anchor_us = 0; // Fronteira que iniciou a sequência atual
+volatile bool is_matrix_commit_pending = false; // Quadro da fronteira recusado na interrupção
+
+/// Quadros-chave da matriz
+anim_color_t matrix_state_frames[3][LED_MATRIX_SIZE];
+anim_color_t matrix_night_frame[LED_MATRIX_SIZE];
+const anim_color_t matrix_black_frame[LED_MATRIX_SIZE] = {0};
+
+const anim_keyframe_t walk_keyframes[] = {
+    {matrix_state_frames[0], 1000, ANIM_HOLD},
+};
+const anim_keyframe_t clearance_keyframes[] = {
+    {matrix_state_frames[1], 500, ANIM_PULSE}, // Pulsa duas vezes por segundo
+};
+const anim_keyframe_t vehicle_keyframes[] = {
+    {matrix_state_frames[2], 1000, ANIM_HOLD},
+};
+// Pisca noturno: meia onda acesa e meia apagada. As bordas coincidem com as fronteiras do LED RGB
+// e do buzzer: o quadro aceso sai inteiro na fronteira e o apagamento suave só começa na fronteira
+// da metade apagada.
+const anim_keyframe_t night_keyframes[] = {
+    {matrix_night_frame, TIMEBASE_BLINK_PERIOD_MS, ANIM_HOLD},
+    {matrix_night_frame, MATRIX_NIGHT_FADE_MS, ANIM_FADE},
+    {matrix_black_frame, TIMEBASE_BLINK_PERIOD_MS - MATRIX_NIGHT_FADE_MS, ANIM_HOLD},
+};
+
+const anim_sequence_t matrix_sequences[] = {
+    {walk_keyframes, count_of(walk_keyframes), true},
+    {clearance_keyframes, count_of(clearance_keyframes), true},
+    {vehicle_keyframes, count_of(vehicle_keyframes), true},
+    {night_keyframes, count_of(night_keyframes), true},
+};
+uint32_t rgb_led_values[3];
+int display_output_id = -1;
+int matrix_output_id = -1;
+
+/// Trechos perfilados pelos contadores da cache XIP
+int xip_animation_id = -1;
+int xip_ui_render_id = -1;
+int xip_ui_flush_id = -1;
+timebase_phase_t display_next_phase; // Fase que o display deve desenhar
+
+/// Fontes dos tópicos do fluxo de estado
+const status_sources_t status_sources = {
+    .phase = status_phase_source,
+    .outputs = status_outputs_source,
+    .stats = status_stats_source,
+};
+
+/// Tabela de tarefas
+#define TASK_PLAN_DESCRIPTOR(id, function, name, stack, period_ms, max_interval_ms, wcet_us, deadline_ms,          \
+                             blocking_us, is_critical)                                                            \
+    [id] = {function, name, #stack, TASK_STACK_SIZE(stack), period_ms, max_interval_ms, wcet_us, deadline_ms,      \
+            is_critical},
+
+const task_descriptor_t task_table[TASK_COUNT] = {
+    TASK_TABLE(TASK_PLAN_DESCRIPTOR)
+#ifdef STACK_PROFILING
+    [TASK_STACK_PROFILER] = {vStackProfilerTask, "Perfilador de Pilha", "STACK_PROFILER_TASK_STACK_SIZE",
+                             TASK_STACK_SIZE(STACK_PROFILER_TASK_STACK_SIZE), STACK_PROFILER_SAMPLE_MS,
+                             STACK_PROFILER_SAMPLE_MS, 0, 0, false},
+#endif
+};
+static_assert(PLANNED_TASK_COUNT < configMAX_PRIORITIES - 1, "prioridades insuficientes para o plano de tarefas");
+
 int main()
 {
+    power_init(); // Antes dos periféricos: todos partem do clock do perfil normal
     stdio_init_all();
+    log_init();
+    xip_profiler_init();
 
     init_btn(BUTTON_B_PIN);
 
+#ifdef RAM_HOT_PATHS
+    // Sem o despachante de callbacks do SDK, que fica na flash: o tratador vai direto para a SRAM
+    gpio_add_raw_irq_handler(BUTTON_B_PIN, gpio_raw_irq_handler);
+    gpio_set_irq_enabled(BUTTON_B_PIN, GPIO_IRQ_EDGE_FALL, true);
+    irq_set_enabled(IO_IRQ_BANK0, true);
+#else
     gpio_set_irq_enabled_with_callback(BUTTON_B_PIN, GPIO_IRQ_EDGE_FALL, true, &gpio_irq_handler);
+#endif
 
-    init_buzzer(BUZZER_A_PIN, 4.0f); // Inicializa o PWM para o buzzer A
-    init_buzzer(BUZZER_B_PIN, 4.0f); // Inicializa o PWM para o buzzer B
-
-    xTaskCreate(vDisplayTask, "Display OLED", configMINIMAL_STACK_SIZE,
-                NULL, tskIDLE_PRIORITY, NULL);
-    xTaskCreate(vRGBLedTask, "Led RGB", configMINIMAL_STACK_SIZE,
-                NULL, tskIDLE_PRIORITY, NULL);
-    xTaskCreate(vLedMatrixTask, "Matriz de Led", configMINIMAL_STACK_SIZE,
-                NULL, tskIDLE_PRIORITY, NULL);
-    xTaskCreate(vModeToggleTask, "Mudar modo", configMINIMAL_STACK_SIZE,
-                NULL, tskIDLE_PRIORITY + 1, NULL);
-    xTaskCreate(vTrafficLightControlTask, "Controle do Semáforo", configMINIMAL_STACK_SIZE,
-                NULL, tskIDLE_PRIORITY, NULL);
-    xTaskCreate(vBuzzerTask, "Buzzer", configMINIMAL_STACK_SIZE,
-                NULL, tskIDLE_PRIORITY, NULL);
+    init_buzzer(BUZZER_A_PIN, BUZZER_COUNTER_HZ); // Inicializa o PWM para o buzzer A
+    init_buzzer(BUZZER_B_PIN, BUZZER_COUNTER_HZ); // Inicializa o PWM para o buzzer B
+    init_outputs();                               // LEDs, matriz e relógio de fase compartilhado
+    detector_init(on_detector_edge, NULL);        // Captura dos laços detectores por PIO e DMA
+    cyclelog_init();                              // Retoma o registro de ciclos gravado na flash
+    status_init(&status_sources);                 // Fluxo binário de estado por assinatura
+
+#ifdef LOG_BENCHMARK
+    log_benchmark(); // Custo de um ponto de chamada do log binário contra a formatação do printf
+#endif
+#ifdef HAL_BENCHMARK
+    hal_benchmark(); // Custo das saídas pela HAL em C++ e pelas APIs em C
+#endif
+#ifdef WS2812B_BENCHMARK
+    ws2812b_parallel_benchmark(); // Transposição e envio de um quadro de 8 fitas de 300 LEDs
+#endif
+#ifdef WEBSTER_BENCHMARK
+    webster_benchmark(); // Pior tempo do plano adaptativo por número de fases e aproximações
+#endif
+
+    // Configurações que dependem de clk_sys são recalculadas a cada troca de perfil
+    power_register_clock_observer(ws2812b_set_clock);
+    power_register_clock_observer(buzzer_set_clock);
+    power_register_clock_observer(display_set_clock);
+    power_register_clock_observer(detector_set_clock);
+    power_register_clock_observer(on_clock_change);
+
+    if (tl_settings.is_coordinated_mode)
+    {
+        coord_init(&coord_config, COORDINATION_LEADER);
+        power_register_clock_observer(coord_set_clock);
+    }
+    if (tl_settings.is_adaptive_mode)
+        adaptive_init();
+
+    // Cria as tarefas com prioridades por taxa monotônica e declara o plano de cada uma ao monitor
+    deadline_monitor_set_exec_clock(task_exec_time_us);
+    for (int id = 0; id < TASK_COUNT; id++)
+    {
+        const task_descriptor_t *task = &task_table[id];
+        TaskHandle_t handle = NULL;
+
+        if (id < PLANNED_TASK_COUNT)
+            deadline_monitor_register(id, task->name, task->max_interval_ms, task->deadline_ms, task->wcet_us,
+                                      task->is_critical);
+
+        UBaseType_t priority = rate_monotonic_priority(id);
+        if (xTaskCreate(task->function, task->name, task->stack_size, NULL, priority, &handle) != pdPASS)
+            panic("Falha ao criar a tarefa %s", task->name);
+        stack_profiler_register(handle, task->stack_size, task->stack_setting);
+        task_handles[id] = handle;
+    }
 
     vTaskStartScheduler();
     panic_unsupported();
 }
 
-void gpio_irq_handler(uint gpio, uint32_t events)
+void HOT_FUNC(gpio_irq_handler)(uint gpio, uint32_t events)
 {
     reset_usb_boot(0, 0);
 }
 
-void vModeToggleTask()
+// Tratador bruto do botão B (build com RAM_HOT_PATHS): reconhece a borda e chama o mesmo tratador.
+void HOT_FUNC(gpio_raw_irq_handler)()
 {
-    init_btn(BUTTON_A_PIN);
-    absolute_time_t last_press = 0;
+    uint32_t events = gpio_get_irq_event_mask(BUTTON_B_PIN) & GPIO_IRQ_EDGE_FALL;
+    if (!events)
+        return;
 
-    while (true)
-    {
-        absolute_time_t now = to_ms_since_boot(get_absolute_time());
+    gpio_acknowledge_irq(BUTTON_B_PIN, events);
+    gpio_irq_handler(BUTTON_B_PIN, events);
+}
 
-        if (btn_is_pressed(BUTTON_A_PIN) && now - last_press > 250)
-        {
-            tl_settings.is_night_mode = !tl_settings.is_night_mode; // Alterna o modo
-            last_press = now;
+// Chamado pelo FreeRTOS ao detectar estouro de pilha na troca de contexto.
+void vApplicationStackOverflowHook(TaskHandle_t task, char *task_name)
+{
+    panic("Estouro de pilha na tarefa %s", task_name);
+}
 
-            if (tl_settings.is_night_mode)
-            {
-                light_state = 1; // Muda para o estado amarelo no modo noturno
-            }
+// Menor período primeiro; empates pelo menor prazo efetivo e depois pela ordem da tabela.
+// tools/rta.py repete esta regra na análise de tempo de resposta.
+static bool rate_monotonic_precedes(int a, int b)
+{
+    const task_descriptor_t *ta = &task_table[a], *tb = &task_table[b];
+    if (ta->period_ms != tb->period_ms)
+        return ta->period_ms < tb->period_ms;
 
-            printf("Modo noturno: %s\n", tl_settings.is_night_mode ? "Ativado" : "Desativado");
-        }
-        vTaskDelay(pdMS_TO_TICKS(10));
+    uint32_t deadline_a = ta->deadline_ms ? ta->deadline_ms : ta->period_ms;
+    uint32_t deadline_b = tb->deadline_ms ? tb->deadline_ms : tb->period_ms;
+    if (deadline_a != deadline_b)
+        return deadline_a < deadline_b;
+    return a < b;
+}
+
+// Prioridade FreeRTOS pela posição da tarefa na ordem por taxa monotônica. Tarefas de diagnóstico
+// fora do plano ficam na prioridade do idle.
+UBaseType_t rate_monotonic_priority(int id)
+{
+    if (id >= PLANNED_TASK_COUNT)
+        return tskIDLE_PRIORITY;
+
+    int rank = 0;
+    for (int other = 0; other < PLANNED_TASK_COUNT; other++)
+    {
+        if (other != id && rate_monotonic_precedes(other, id))
+            rank++;
     }
+    return tskIDLE_PRIORITY + PLANNED_TASK_COUNT - rank;
 }
 
-void vRGBLedTask()
+// Tempo de CPU da tarefa corrente: contador de run time das fatias anteriores mais a fatia em curso.
+// Uma troca de contexto durante a leitura muda o instante de entrada e a leitura é refeita.
+uint32_t task_exec_time_us()
+{
+    TaskStatus_t status;
+    uint32_t switched_in_us, now_us;
+    do
+    {
+        switched_in_us = task_switched_in_us;
+        vTaskGetInfo(NULL, &status, pdFALSE, eRunning);
+        now_us = timer_hw->timerawl;
+    } while (switched_in_us != task_switched_in_us);
 
+    return status.ulRunTimeCounter + (now_us - switched_in_us);
+}
+
+// Encerra o job atual da tarefa, dorme e marca a liberação do próximo job.
+void task_delay_ms(task_id_t task_id, uint32_t ms)
+{
+    deadline_job_end(task_id);
+    vTaskDelay(pdMS_TO_TICKS(ms));
+    deadline_job_begin(task_id);
+}
+
+// Aguarda uma notificação (ou o timeout) como fim de job da tarefa; retorna os bits recebidos.
+uint32_t task_wait_notify(task_id_t task_id, uint32_t timeout_ms)
+{
+    uint32_t bits = 0;
+    deadline_job_end(task_id);
+    xTaskNotifyWait(0, UINT32_MAX, &bits, pdMS_TO_TICKS(timeout_ms));
+    deadline_job_begin(task_id);
+    return bits;
+}
+
+// Fase correspondente ao estado atual do controle.
+timebase_phase_t current_phase()
+{
+    return (timebase_phase_t){
+        .light_state = light_state,
+        .is_night_mode = tl_settings.is_night_mode,
+        .is_fault_mode = tl_settings.is_fault_mode,
+        .blink_on = true,
+    };
+}
+
+// Publica o estado atual do semáforo no relógio de fase compartilhado.
+void publish_phase()
+{
+    timebase_phase_t phase = current_phase();
+    timebase_publish(&phase);
+}
+
+// Agenda a fase atual para um instante absoluto (ciclo coordenado).
+void schedule_phase(uint64_t boundary_us)
+{
+    timebase_phase_t phase = current_phase();
+    timebase_schedule(&phase, boundary_us);
+}
+
+// Inicializa as saídas, pré-calcula o estado de cada fase e as registra no relógio de fase.
+void init_outputs()
 {
     init_leds();
+    ws2812b_init(MATRIX_LED_PIN);
+    ws2812b_dma_init();
+
+    for (int state = 0; state < 3; state++)
+    {
+        rgb_led_values[state] = (tl_settings.rgb_led_state[state][0] ? 1u << RED_LED_PIN : 0) |
+                                (tl_settings.rgb_led_state[state][1] ? 1u << GREEN_LED_PIN : 0) |
+                                (tl_settings.rgb_led_state[state][2] ? 1u << BLUE_LED_PIN : 0);
+
+        anim_color_t color = {tl_settings.matrix_led_colors[state][0], tl_settings.matrix_led_colors[state][1],
+                              tl_settings.matrix_led_colors[state][2]};
+        canvas_pixel(matrix_state_frames[state], tl_settings.matrix_led_positions[state][0],
+                     tl_settings.matrix_led_positions[state][1], color);
+        if (state == 1)
+            canvas_pixel(matrix_night_frame, tl_settings.matrix_led_positions[1][0],
+                         tl_settings.matrix_led_positions[1][1], color); // Amarelo piscante no centro
+    }
+
+    // Quadro inicial de cada tipo de fase, enviado pela interrupção na fronteira
+    for (int kind = 0; kind < MATRIX_FRAME_COUNT; kind++)
+    {
+        animation_render(matrix_sequence_for(kind), matrix_sequence_offset_ms(kind));
+        ws2812b_serialize(matrix_frames[kind]);
+    }
+    ws2812b_clear();
+    ws2812b_write();
+
+    // Saídas imediatas primeiro: o desvio entre elas é medido em cada fronteira
+    timebase_init();
+    timebase_register_output("Led RGB", NULL, commit_rgb_led, false);
+    matrix_output_id = timebase_register_output("Matriz de Led", NULL, commit_led_matrix, false);
+    timebase_register_output("Buzzer", NULL, commit_buzzer, false);
+    display_output_id = timebase_register_output("Display OLED", prepare_display, commit_display, true);
+    timebase_register_output("Registro de Ciclos", prepare_cyclelog, NULL, false);
+
+    xip_animation_id = xip_profiler_register("Animacao");
+    xip_ui_render_id = xip_profiler_register("UI desenho");
+    xip_ui_flush_id = xip_profiler_register("UI envio");
+}
+
+bool HOT_FUNC(commit_rgb_led)(const timebase_phase_t *phase)
+{
+    uint32_t value;
+    if (phase->is_night_mode)
+        value = phase->blink_on ? rgb_led_values[1] : 0; // Amarelo piscante
+    else
+        value = rgb_led_values[phase->light_state];
+
+    gpio_put_masked(LEDS_MASK, value); // Uma única escrita no SIO, sem transição intermediária
+    return true;
+}
+
+// Sequência de animação de cada tipo de fase (as duas metades do pisca usam a mesma).
+const anim_sequence_t *matrix_sequence_for(int kind)
+{
+    return &matrix_sequences[kind == MATRIX_NIGHT_OFF_FRAME ? MATRIX_NIGHT_ON_FRAME : kind];
+}
+
+// Instante da sequência em que cada tipo de fase começa.
+uint32_t matrix_sequence_offset_ms(int kind)
+{
+    return kind == MATRIX_NIGHT_OFF_FRAME ? TIMEBASE_BLINK_PERIOD_MS : 0;
+}
+
+bool HOT_FUNC(commit_led_matrix)(const timebase_phase_t *phase)
+{
+    int kind;
+    if (phase->is_night_mode)
+        kind = phase->blink_on ? MATRIX_NIGHT_ON_FRAME : MATRIX_NIGHT_OFF_FRAME;
+    else
+        kind = phase->light_state;
+
+    // O primeiro quadro da fase sai na fronteira; a tarefa anima a partir daí. Se o DMA ou o reset
+    // do quadro anterior ainda estiver em curso, a tarefa reenvia o quadro assim que puder; a âncora
+    // continua na fronteira, para a animação ficar alinhada às demais saídas.
+    bool is_sent = ws2812b_write_frame_dma(matrix_frames[kind]);
+    matrix_kind = kind;
+    matrix_anchor_us = phase->boundary_us;
+    is_matrix_commit_pending = !is_sent;
+    return is_sent;
+}
+
+// Reenvia o quadro de fronteira recusado na interrupção e registra o atraso da efetivação no
+// relógio de fase. Retorna true enquanto o quadro continuar pendente.
+bool retry_matrix_commit()
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+    if (is_matrix_commit_pending && ws2812b_write_frame_dma(matrix_frames[matrix_kind]))
+    {
+        is_matrix_commit_pending = false;
+        timebase_mark_committed(matrix_output_id, matrix_anchor_us);
+    }
+    bool is_pending = is_matrix_commit_pending;
+    restore_interrupts(irq_state);
+    return is_pending;
+}
+
+bool HOT_FUNC(commit_buzzer)(const timebase_phase_t *phase)
+{
+    if (phase->is_night_mode)
+    {
+        stop_tone(BUZZER_B_PIN); // Garante que o buzzer B está parado
+        if (phase->blink_on)
+            play_tone(BUZZER_A_PIN, 150); // Liga buzzer A
+        else
+            stop_tone(BUZZER_A_PIN); // Desliga buzzer A
+        return true;
+    }
+
+    stop_tone(BUZZER_A_PIN); // Garante que o buzzer A está parado
+    play_tone(BUZZER_B_PIN, tl_settings.buzzer_frequency[phase->light_state]);
+
+    // O restante do padrão intermitente da fase é conduzido pela tarefa do buzzer
+    BaseType_t higher_priority_woken = pdFALSE;
+    xTaskNotifyFromISR(task_handles[TASK_BUZZER], phase->light_state + 1, eSetValueWithOverwrite,
+                       &higher_priority_woken);
+    portYIELD_FROM_ISR(higher_priority_woken);
+    return true;
+}
+
+void prepare_display(const timebase_phase_t *phase)
+{
+    display_next_phase = *phase;
+    xTaskNotify(task_handles[TASK_DISPLAY], DISPLAY_NOTIFY_PREPARE, eSetBits);
+}
+
+bool HOT_FUNC(commit_display)(const timebase_phase_t *phase)
+{
+    BaseType_t higher_priority_woken = pdFALSE;
+    xTaskNotifyFromISR(task_handles[TASK_DISPLAY], DISPLAY_NOTIFY_COMMIT, eSetBits, &higher_priority_woken);
+    portYIELD_FROM_ISR(higher_priority_woken);
+    return true;
+}
+
+// Fecha os ciclos do registro a partir das fases agendadas, com os contadores acumulados até aqui.
+void prepare_cyclelog(const timebase_phase_t *phase)
+{
+    cyclelog_counters_t totals = {.vehicles = detector_vehicle_total(), .misses = total_deadline_misses()};
+    actuation_stats_t actuation;
+    actuation_get_stats(&actuation);
+    totals.pedestrian_calls = actuation.served_calls;
+
+    uint8_t flags = (phase->is_night_mode ? CYCLELOG_FLAG_NIGHT : 0) |
+                    (phase->is_fault_mode ? CYCLELOG_FLAG_FAULT : 0) |
+                    (tl_settings.is_actuated_mode ? CYCLELOG_FLAG_ACTUATED : 0) |
+                    (tl_settings.is_coordinated_mode ? CYCLELOG_FLAG_COORDINATED : 0) |
+                    (tl_settings.is_adaptive_mode ? CYCLELOG_FLAG_ADAPTIVE : 0);
+    cyclelog_on_phase((uint32_t)(phase->boundary_us / 1000), phase->light_state, flags, &totals);
+}
+
+// Perdas de prazo de todas as tarefas desde o boot.
+uint32_t total_deadline_misses()
+{
+    uint32_t misses = 0;
+    for (int id = 0; id < TASK_COUNT; id++)
+    {
+        deadline_task_stats_t stats;
+        if (deadline_monitor_get_stats(id, &stats))
+            misses += stats.misses;
+    }
+    return misses;
+}
 
+// Fase efetivada pelo relógio de fase, com os modos ativos.
+void status_phase_source(status_phase_t *status)
+{
+    timebase_phase_t phase;
+    timebase_get_current(&phase);
+    *status = (status_phase_t){
+        .sequence = phase.sequence,
+        .boundary_us = (uint32_t)phase.boundary_us,
+        .light_state = phase.light_state,
+        .flags = (phase.is_night_mode ? STATUS_FLAG_NIGHT : 0) | (phase.is_fault_mode ? STATUS_FLAG_FAULT : 0) |
+                 (tl_settings.is_actuated_mode ? STATUS_FLAG_ACTUATED : 0) |
+                 (tl_settings.is_coordinated_mode ? STATUS_FLAG_COORDINATED : 0) |
+                 (tl_settings.is_adaptive_mode ? STATUS_FLAG_ADAPTIVE : 0) |
+                 (phase.blink_on ? STATUS_FLAG_BLINK_ON : 0),
+    };
+}
+
+// Níveis efetivos das saídas: LED RGB lido do SIO, quadro da matriz e tons dos buzzers.
+void status_outputs_source(status_outputs_t *status)
+{
+    uint32_t leds = gpio_get_all() & LEDS_MASK;
+    *status = (status_outputs_t){
+        .leds = (leds & (1u << RED_LED_PIN) ? 1 : 0) | (leds & (1u << GREEN_LED_PIN) ? 2 : 0) |
+                (leds & (1u << BLUE_LED_PIN) ? 4 : 0),
+        .matrix_kind = matrix_kind,
+        .buzzer_hz = {buzzer_get_tone(BUZZER_A_PIN), buzzer_get_tone(BUZZER_B_PIN)},
+    };
+}
+
+// Contadores acumulados desde o boot.
+void status_stats_source(status_stats_t *status)
+{
+    actuation_stats_t actuation;
+    actuation_get_stats(&actuation);
+    *status = (status_stats_t){
+        .uptime_ms = to_ms_since_boot(get_absolute_time()),
+        .misses = total_deadline_misses(),
+        .pedestrian_calls = actuation.served_calls,
+        .max_latency_ms = actuation.max_latency_ms,
+        .vehicles = detector_vehicle_total(),
+    };
+}
+
+void toggle_night_mode()
+{
+    if (tl_settings.is_fault_mode)
+        return; // O modo noturno não alterna enquanto o modo de segurança estiver ativo
+
+    tl_settings.is_night_mode = !tl_settings.is_night_mode; // Alterna o modo
+
+    if (tl_settings.is_night_mode)
+    {
+        light_state = 1; // Muda para o estado amarelo no modo noturno
+    }
+
+    publish_phase();
+    if (tl_settings.is_night_mode)
+        LOG0(LOG_NIGHT_MODE_ON);
+    else
+        LOG0(LOG_NIGHT_MODE_OFF);
+    apply_power_profile();
+}
+
+// Modo noturno usa clock reduzido e tickless idle; o modo de segurança mantém o clock máximo.
+void apply_power_profile()
+{
+    bool is_low_power = tl_settings.is_night_mode && !tl_settings.is_fault_mode;
+    power_set_profile(is_low_power ? POWER_PROFILE_NIGHT : POWER_PROFILE_NORMAL);
+}
+
+// Após a troca de clock, o relógio de fase passa a medir a latência apenas no novo perfil.
+void on_clock_change(uint32_t sys_hz)
+{
+    timebase_reset_stats();
+}
+
+void vModeToggleTask()
+{
+    init_btn(BUTTON_A_PIN);
+    init_btn(VEHICLE_DETECTOR_PIN);
+    uint32_t last_press = 0;
+    uint32_t press_start = 0;
+    bool was_pressed = false;
+    bool long_press_handled = false;
+    bool was_vehicle_present = false;
+
+    deadline_job_begin(TASK_MODE_TOGGLE);
     while (true)
     {
-        if (tl_settings.is_night_mode)
-        {
-            // Pisca lentamente no modo noturno
-            gpio_put(RED_LED_PIN, true);
-            gpio_put(GREEN_LED_PIN, true);
-            gpio_put(BLUE_LED_PIN, false); // Amarelo
-            for (int i = 0; i < 40; i++) // Liga por 2000ms em fatias de 50ms
-            {
-                if (!tl_settings.is_night_mode) break;
-                vTaskDelay(pdMS_TO_TICKS(50));
-            }
+        uint32_t now = to_ms_since_boot(get_absolute_time());
+        bool pressed = btn_is_pressed(BUTTON_A_PIN);
 
-            gpio_put(RED_LED_PIN, false);
-            gpio_put(GREEN_LED_PIN, false);
-            gpio_put(BLUE_LED_PIN, false); // Desliga
-            for (int i = 0; i < 40; i++) // Desliga por 2000ms em fatias de 50ms
+        if (!tl_settings.is_actuated_mode && !tl_settings.is_adaptive_mode)
+        {
+            if (pressed && now - last_press > 250)
             {
-                if (!tl_settings.is_night_mode) break;
-                vTaskDelay(pdMS_TO_TICKS(50));
+                toggle_night_mode();
+                last_press = now;
             }
         }
-        else
+        else if (pressed && !was_pressed && now - last_press > 250)
+        {
+            // Início de uma pressão: a decisão entre chamada e troca de modo fica para a soltura
+            press_start = now;
+            last_press = now;
+            long_press_handled = false;
+        }
+        else if (pressed && was_pressed && !long_press_handled && now - press_start >= LONG_PRESS_MS)
         {
-            gpio_put(RED_LED_PIN, tl_settings.rgb_led_state[light_state][0]);
-            gpio_put(GREEN_LED_PIN, tl_settings.rgb_led_state[light_state][1]);
-            gpio_put(BLUE_LED_PIN, tl_settings.rgb_led_state[light_state][2]);
+            toggle_night_mode();
+            long_press_handled = true;
         }
-        vTaskDelay(pdMS_TO_TICKS(10)); // Atualiza frequentemente
+        else if (!pressed && was_pressed && !long_press_handled && !tl_settings.is_night_mode)
+        {
+            if (tl_settings.is_adaptive_mode)
+                adaptive_count(ADAPTIVE_APPROACH_PEDESTRIAN); // Demanda de pedestres do próximo plano
+            else
+                actuation_pedestrian_call(press_start); // Latência medida a partir do aperto
+            LOG0(LOG_PEDESTRIAN_CALL);
+        }
+        was_pressed = pressed;
+
+        // O detector veicular é amostrado a cada ciclo e prolonga a fase veicular; no modo adaptativo,
+        // cada acionamento conta um veículo no primeiro laço
+        bool is_vehicle_present = btn_is_pressed(VEHICLE_DETECTOR_PIN);
+        if (is_vehicle_present && tl_settings.is_adaptive_mode && !was_vehicle_present)
+            adaptive_count(ADAPTIVE_APPROACH_VEHICLE);
+        else if (is_vehicle_present && !tl_settings.is_adaptive_mode)
+            actuation_vehicle_call(now);
+        was_vehicle_present = is_vehicle_present;
+
+        task_delay_ms(TASK_MODE_TOGGLE, 10);
     }
 }
 
 void vLedMatrixTask()
 {
-    ws2812b_init(MATRIX_LED_PIN);
-    ws2812b_clear();
+#ifdef ANIMATION_BENCHMARK
+    for (int kind = 0; kind < MATRIX_FRAME_COUNT - 1; kind++)
+        animation_benchmark(&matrix_sequences[kind]);
+#endif
+
+    uint64_t next_frame_us = time_us_64();
+    int back = 0;
 
+    deadline_job_begin(TASK_LED_MATRIX);
     while (true)
     {
-        if (tl_settings.is_night_mode)
+        // O quadro da fronteira tem precedência sobre a animação: tenta a cada tick até sair
+        if (retry_matrix_commit())
         {
-            // Pisca lentamente no modo noturno
-            ws2812b_clear();
-            ws2812b_set_led(12, 4, 8, 0); // Define o LED 12 como amarelo
-            ws2812b_write();
-            for (int i = 0; i < 40; i++) // Liga por 2000ms em fatias de 50ms
-            {
-                if (!tl_settings.is_night_mode) break;
-                vTaskDelay(pdMS_TO_TICKS(50));
-            }
-
-            ws2812b_clear(); // Desliga todos os LEDs
-            ws2812b_write();
-            for (int i = 0; i < 40; i++) // Desliga por 2000ms em fatias de 50ms
-            {
-                if (!tl_settings.is_night_mode) break;
-                vTaskDelay(pdMS_TO_TICKS(50));
-            }
+            task_delay_ms(TASK_LED_MATRIX, 1);
+            continue;
         }
-        else
+
+        uint64_t now = time_us_64();
+        uint64_t boundary_us;
+        bool near_boundary = timebase_get_pending_boundary(&boundary_us) && boundary_us > now &&
+                             boundary_us - now < MATRIX_BOUNDARY_GUARD_US;
+
+        // Perto de uma fronteira o DMA fica livre para o quadro da interrupção
+        if (!near_boundary && now >= matrix_anchor_us)
         {
-            ws2812b_clear();
-            ws2812b_set_led(tl_settings.matrix_led_indexes[light_state],
-                            tl_settings.matrix_led_colors[light_state][0],
-                            tl_settings.matrix_led_colors[light_state][1],
-                            tl_settings.matrix_led_colors[light_state][2]);
-            ws2812b_write();
+            uint32_t irq_state = save_and_disable_interrupts();
+            int kind = matrix_kind;
+            uint64_t anchor_us = matrix_anchor_us;
+            restore_interrupts(irq_state);
+
+            uint32_t time_ms = (uint32_t)((now - anchor_us) / 1000) + matrix_sequence_offset_ms(kind);
+            xip_sample_t sample;
+            xip_profiler_begin(&sample);
+            animation_render(matrix_sequence_for(kind), time_ms);
+            ws2812b_serialize(matrix_animation_frames[back]);
+            xip_profiler_end(xip_animation_id, &sample);
+            ws2812b_write_frame_dma(matrix_animation_frames[back]);
+            back ^= 1;
         }
-        vTaskDelay(pdMS_TO_TICKS(10)); // Atualiza frequentemente
+
+        // Quadros a 60 fps: o próximo instante é acumulado em microssegundos
+        next_frame_us += ANIMATION_FRAME_US;
+        now = time_us_64();
+        if (next_frame_us < now)
+            next_frame_us = now; // Quadro perdido: realinha sem tentar recuperar
+        task_delay_ms(TASK_LED_MATRIX, (uint32_t)((next_frame_us - now + 999) / 1000));
     }
 }
 
@@ -192,99 +839,477 @@ void vDisplayTask()
     ssd1306_t ssd;      // Inicializa a estrutura do display
     init_display(&ssd); // Inicializa o display
 
-    char mode_text[20]; // Buffer para armazenar o texto do modo
-    bool cor = true;
+    // Tela de estado: cada elemento é redesenhado e enviado apenas quando muda
+    ui_screen_t screen;
+    ui_widget_t border, title, divider, message_top, message_bottom, message_single, cycle_label;
+    ui_screen_init(&screen, &ssd);
+    ui_frame_init(&border, (ui_rect_t){3, 3, 122, 60}, false);
+    ui_label_init(&title, (ui_rect_t){4, 8, 120, 8}, "", true);
+    ui_frame_init(&divider, (ui_rect_t){3, 19, 125, 1}, true);
+    ui_label_init(&message_top, (ui_rect_t){4, 28, 120, 8}, "", true);
+    ui_label_init(&message_bottom, (ui_rect_t){4, 38, 120, 8}, "", true);
+    ui_label_init(&message_single, (ui_rect_t){4, 36, 120, 8}, "", true);
+    ui_label_init(&cycle_label, (ui_rect_t){4, 50, 120, 8}, "", true);
+    ui_add(&screen, &border);
+    ui_add(&screen, &title);
+    ui_add(&screen, &divider);
+    ui_add(&screen, &message_top);
+    ui_add(&screen, &message_bottom);
+    ui_add(&screen, &message_single);
+    ui_add(&screen, &cycle_label);
+
+#ifdef UI_BENCHMARK
+    ui_benchmark(&screen, &cycle_label);
+#endif
+
+    char cycle_text[UI_LABEL_MAX + 1];
+    uint32_t cycles = 0;
+    uint8_t last_state = 0;
+    uint64_t drawn_boundary_us = 0;
 
+    deadline_job_begin(TASK_DISPLAY);
     while (true)
     {
+        uint32_t bits = task_wait_notify(TASK_DISPLAY, OUTPUT_IDLE_TIMEOUT_MS);
 
-        if (tl_settings.is_night_mode)
-            sprintf(mode_text, "Modo Noturno"); // Define o texto do modo
-        else
-            sprintf(mode_text, "Modo Normal"); // Define o texto do modo
+        if (bits & DISPLAY_NOTIFY_PREPARE)
+        {
+            // Desenha a próxima fase antes da fronteira; o envio ocorre na efetivação
+            timebase_phase_t phase = display_next_phase;
+            drawn_boundary_us = phase.boundary_us;
 
-        ssd1306_fill(&ssd, !cor);                     // Limpa o display
-        ssd1306_rect(&ssd, 3, 3, 122, 60, cor, !cor); // Desenha um retângulo
-        draw_centered_text(&ssd, mode_text, 8);       // Desenha o texto do modo
-        ssd1306_line(&ssd, 3, 19, 127, 19, cor);      // Desenha uma linha
+            if (phase.is_fault_mode)
+                ui_label_set_text(&screen, &title, "Modo Falha");
+            else if (phase.is_night_mode)
+                ui_label_set_text(&screen, &title, "Modo Noturno");
+            else
+                ui_label_set_text(&screen, &title, "Modo Normal");
 
-        if (light_state == 0)
-        {
-            draw_centered_text(&ssd, "Pode", 28);       // Desenha "Pode"
-            draw_centered_text(&ssd, "Atravessar", 38); // Desenha "Atravessar"
+            bool is_walk = phase.light_state == 0;
+            ui_set_visible(&screen, &message_top, is_walk);
+            ui_set_visible(&screen, &message_bottom, is_walk);
+            ui_set_visible(&screen, &message_single, !is_walk);
+            ui_label_set_text(&screen, &message_top, "Pode");
+            ui_label_set_text(&screen, &message_bottom, "Atravessar");
+            ui_label_set_text(&screen, &message_single, phase.light_state == 1 ? "Atencao!" : "Pare!");
+
+            // Um ciclo termina a cada nova travessia de pedestres
+            if (is_walk && last_state != 0)
+                cycles++;
+            last_state = phase.light_state;
+            snprintf(cycle_text, sizeof(cycle_text), "Ciclo %lu", (unsigned long)cycles);
+            ui_label_set_text(&screen, &cycle_label, cycle_text);
+
+            xip_sample_t sample;
+            xip_profiler_begin(&sample);
+            ui_render(&screen);
+            xip_profiler_end(xip_ui_render_id, &sample);
         }
-        else if (light_state == 1)
-            draw_centered_text(&ssd, "Atencao!", 36); // Desenha "Atenção"
-        else if (light_state == 2)
-            draw_centered_text(&ssd, "Pare!", 36); // Desenha "Pare"
 
-        ssd1306_send_data(&ssd);        // Atualiza o display
-        vTaskDelay(pdMS_TO_TICKS(200)); // Atualiza frequentemente
+        if (bits & DISPLAY_NOTIFY_COMMIT)
+        {
+            timebase_mark_committed(display_output_id, drawn_boundary_us);
+            xip_sample_t sample;
+            xip_profiler_begin(&sample);
+            power_hold(); // Uma troca de clock pedida durante o envio espera o fim dele
+            display_apply_clock();
+            ui_flush(&screen); // Envia apenas as regiões alteradas
+            power_release();
+            xip_profiler_end(xip_ui_flush_id, &sample);
+        }
     }
 }
 
 void vTrafficLightControlTask()
 {
+    actuation_init(&actuation_timing);
+    uint32_t state_start = to_ms_since_boot(get_absolute_time());
+    publish_phase(); // Primeira fronteira: todas as saídas partem do mesmo estado
+
+    deadline_job_begin(TASK_TRAFFIC_LIGHT_CONTROL);
     while (true)
     {
-        if (!tl_settings.is_night_mode)
+        if (tl_settings.is_night_mode)
+        {
+            // No modo noturno, mantém o estado fixo
+            task_delay_ms(TASK_TRAFFIC_LIGHT_CONTROL, 100); // Aguarda um tempo menor no modo noturno
+            state_start = to_ms_since_boot(get_absolute_time());
+        }
+        else if (tl_settings.is_coordinated_mode)
+        {
+            run_coordinated_cycle();
+            state_start = to_ms_since_boot(get_absolute_time());
+        }
+        else if (tl_settings.is_adaptive_mode)
+        {
+            run_adaptive_cycle();
+            state_start = to_ms_since_boot(get_absolute_time());
+        }
+        else if (tl_settings.is_actuated_mode)
+        {
+            // Avalia chamadas e detecções e troca de fase no primeiro instante seguro
+            uint32_t now = to_ms_since_boot(get_absolute_time());
+            int next_state = actuation_next_state(light_state, state_start, now);
+            if (next_state != light_state)
+            {
+                light_state = next_state;
+                state_start = now;
+                publish_phase();
+            }
+            task_delay_ms(TASK_TRAFFIC_LIGHT_CONTROL, ACTUATION_TICK_MS);
+        }
+        else
         {
             // Atualiza o estado do semáforo
             light_state = (light_state + 1) % 3;               // Incrementa e reinicia para 0 após 2
-            vTaskDelay(pdMS_TO_TICKS(TRAFFIC_LIGHT_DELAY_MS)); // Aguarda o tempo do estado atual
+            publish_phase();
+            task_delay_ms(TASK_TRAFFIC_LIGHT_CONTROL, TRAFFIC_LIGHT_DELAY_MS); // Aguarda o tempo do estado atual
+        }
+    }
+}
+
+// Executa um ciclo travado ao controlador a montante: cada fase começa em um instante absoluto
+// a partir do início de ciclo corrigido pelo servo de fase. O vermelho dura até o próximo início.
+void run_coordinated_cycle()
+{
+    // Após o modo noturno, os ciclos que já deveriam ter começado são pulados: o próximo
+    // início precisa de ao menos a antecedência do relógio de fase
+    coord_skip_missed_cycles(time_us_64() + TIMEBASE_LEAD_MS * 1000ull);
+
+    // O início pode mudar a cada quadro de sincronismo: é relido a cada espera
+    uint64_t start;
+    while ((start = coord_next_cycle_start()) > time_us_64() + 2 * TIMEBASE_LEAD_MS * 1000ull)
+    {
+        uint32_t wait_ms = (start - time_us_64()) / 1000 - TIMEBASE_LEAD_MS;
+        task_delay_ms(TASK_TRAFFIC_LIGHT_CONTROL, MIN(wait_ms, TRAFFIC_LIGHT_DELAY_MS));
+        if (tl_settings.is_night_mode)
+            return;
+    }
+
+    start = coord_begin_cycle();
+    for (int state = 0; state < 3; state++)
+    {
+        uint64_t boundary = start + state * TRAFFIC_LIGHT_DELAY_MS * 1000ull;
+        uint64_t now = time_us_64();
+        if (boundary > now + TIMEBASE_LEAD_MS * 1000ull)
+            task_delay_ms(TASK_TRAFFIC_LIGHT_CONTROL, (boundary - now) / 1000 - TIMEBASE_LEAD_MS);
+        if (tl_settings.is_night_mode)
+            return;
+
+        light_state = state;
+        schedule_phase(boundary);
+    }
+}
+
+// Configura o plano de Webster: a fase de pedestres (verde e amarelo como tempo perdido) e a fase
+// veicular (vermelho), com os mesmos mínimos do modo atuado.
+void adaptive_init()
+{
+    webster_config_t config = {
+        .phase_count = 2,
+        .approach_count = ADAPTIVE_APPROACHES,
+        .lost_ms = {[ADAPTIVE_PHASE_WALK] = TRAFFIC_LIGHT_DELAY_MS,
+                    [ADAPTIVE_PHASE_VEHICLE] = ADAPTIVE_STARTUP_LOST_MS},
+        .min_green_ms = {[ADAPTIVE_PHASE_WALK] = actuation_timing.walk_ms,
+                         [ADAPTIVE_PHASE_VEHICLE] = actuation_timing.min_vehicle_green_ms},
+        .min_cycle_ms = COORD_CYCLE_MS, // Nunca abaixo do ciclo de tempo fixo
+        .max_cycle_ms = ADAPTIVE_MAX_CYCLE_MS,
+        .max_ratio_q16 = 58982, // Y = 0,9: interseção saturada
+        .smoothing_q8 = 128,    // Metade da nova medição a cada ciclo
+    };
+    config.approaches[ADAPTIVE_APPROACH_PEDESTRIAN] =
+        (webster_approach_t){ADAPTIVE_PHASE_WALK, ADAPTIVE_PEDESTRIAN_SATURATION_PER_H};
+    for (uint8_t channel = 0; channel < DETECTOR_CHANNELS; channel++)
+        config.approaches[ADAPTIVE_APPROACH_VEHICLE + channel] =
+            (webster_approach_t){ADAPTIVE_PHASE_VEHICLE, ADAPTIVE_VEHICLE_SATURATION_PER_H};
+
+    if (!webster_init(&adaptive_optimizer, &config))
+        panic("Configuracao invalida do plano adaptativo");
+    adaptive_counts_start_us = time_us_64();
+}
+
+// Conta uma unidade de demanda na aproximação até o próximo plano (satura em 16 bits).
+void adaptive_count(uint8_t approach)
+{
+    uint32_t irq_state = save_and_disable_interrupts();
+    if (adaptive_counts[approach] < UINT16_MAX)
+        adaptive_counts[approach]++;
+    restore_interrupts(irq_state);
+}
+
+// Dorme até a antecedência de publicação da fronteira, em esperas de no máximo TRAFFIC_LIGHT_DELAY_MS
+// (o intervalo declarado ao monitor de prazos). Retorna false se o modo noturno foi ativado.
+bool adaptive_wait_boundary(uint64_t boundary_us)
+{
+    uint64_t now;
+    while (boundary_us > (now = time_us_64()) + TIMEBASE_LEAD_MS * 1000ull)
+    {
+        uint32_t wait_ms = (boundary_us - now) / 1000 - TIMEBASE_LEAD_MS;
+        task_delay_ms(TASK_TRAFFIC_LIGHT_CONTROL, MAX(MIN(wait_ms, TRAFFIC_LIGHT_DELAY_MS), 1));
+        if (tl_settings.is_night_mode)
+            return false;
+    }
+    return !tl_settings.is_night_mode;
+}
+
+// Executa um ciclo do plano adaptativo. Na fronteira de início, as contagens desde o ciclo anterior
+// atualizam o plano de Webster, que vale para o ciclo inteiro: verde de pedestres, amarelo (tempo
+// perdido da fase de pedestres) e vermelho até o próximo início.
+void run_adaptive_cycle()
+{
+    uint64_t now = time_us_64();
+    if (adaptive_cycle_start_us < now + TIMEBASE_LEAD_MS * 1000ull)
+        adaptive_cycle_start_us = now + TIMEBASE_LEAD_MS * 1000ull; // Primeiro ciclo ou fim do modo noturno
+    uint64_t start = adaptive_cycle_start_us;
+    if (!adaptive_wait_boundary(start))
+        return;
+
+    uint16_t counts[ADAPTIVE_APPROACHES];
+    uint32_t irq_state = save_and_disable_interrupts();
+    for (int i = 0; i < ADAPTIVE_APPROACHES; i++)
+    {
+        counts[i] = adaptive_counts[i];
+        adaptive_counts[i] = 0;
+    }
+    restore_interrupts(irq_state);
+
+    const webster_plan_t *plan =
+        webster_update(&adaptive_optimizer, counts, (uint32_t)((start - adaptive_counts_start_us) / 1000));
+    adaptive_counts_start_us = start;
+    LOG4(LOG_ADAPTIVE_PLAN, plan->cycle_ms, plan->green_ms[ADAPTIVE_PHASE_WALK],
+         plan->green_ms[ADAPTIVE_PHASE_VEHICLE], plan->ratio_q16);
+
+    uint32_t walk_ms = plan->green_ms[ADAPTIVE_PHASE_WALK];
+    uint32_t clearance_ms = adaptive_optimizer.config.lost_ms[ADAPTIVE_PHASE_WALK];
+    const uint32_t state_offsets_ms[3] = {0, walk_ms, walk_ms + clearance_ms};
+    for (int state = 0; state < 3; state++)
+    {
+        uint64_t boundary = start + state_offsets_ms[state] * 1000ull;
+        if (!adaptive_wait_boundary(boundary))
+            return;
+
+        light_state = state;
+        schedule_phase(boundary);
+    }
+    adaptive_cycle_start_us = start + plan->cycle_ms * 1000ull;
+}
+
+void vBuzzerTask()
+{
+    uint32_t wait_ms = OUTPUT_IDLE_TIMEOUT_MS;
+    int state = -1;       // Estado cujo padrão está em execução (-1: nenhum)
+    bool is_active = false;
+
+    deadline_job_begin(TASK_BUZZER);
+    while (true)
+    {
+        // A fronteira de fase já ligou o tom; aqui só se alterna o padrão ativo/inativo
+        uint32_t notified_state = task_wait_notify(TASK_BUZZER, wait_ms);
+
+        if (notified_state)
+        {
+            state = notified_state - 1;
+            is_active = true;
+            wait_ms = tl_settings.buzzer_active_time[state];
+        }
+        else if (state >= 0 && !tl_settings.is_night_mode)
+        {
+            is_active = !is_active;
+            if (is_active)
+                play_tone(BUZZER_B_PIN, tl_settings.buzzer_frequency[state]);
+            else
+                stop_tone(BUZZER_B_PIN);
+            wait_ms = is_active ? tl_settings.buzzer_active_time[state] : tl_settings.buzzer_inactive_time[state];
         }
         else
         {
-            // No modo noturno, mantém o estado fixo
-            vTaskDelay(pdMS_TO_TICKS(100)); // Aguarda um tempo menor no modo noturno
+            state = -1; // Modo noturno: o pisca é conduzido só pelas fronteiras
+            wait_ms = OUTPUT_IDLE_TIMEOUT_MS;
         }
     }
 }
 
-void vBuzzerTask()
+void vDeadlineMonitorTask()
 {
-    init_buzzer(BUZZER_A_PIN, 4.0f); // Inicializa o PWM para o buzzer A
-    init_buzzer(BUZZER_B_PIN, 4.0f); // Inicializa o PWM para o buzzer B
+    bool was_night_mode = false; // Modo noturno antes da entrada no modo de segurança
+    deadline_monitor_init(WATCHDOG_TIMEOUT_MS);
 
+    deadline_job_begin(TASK_DEADLINE_MONITOR);
     while (true)
     {
-        if (tl_settings.is_night_mode)
+        deadline_action_t action = deadline_monitor_check();
+
+        if ((action == DEADLINE_ACTION_FALLBACK || action == DEADLINE_ACTION_RESET) && !tl_settings.is_fault_mode)
+        {
+            // O controle perdeu o prazo: as saídas passam ao amarelo piscante
+            was_night_mode = tl_settings.is_night_mode;
+            tl_settings.is_fault_mode = true;
+            tl_settings.is_night_mode = true;
+            light_state = 1;
+            publish_phase();
+            apply_power_profile();
+            LOG0(LOG_FAULT_MODE);
+            xTaskNotify(task_handles[TASK_REPORT], REPORT_NOTIFY_FAULT, eSetBits);
+        }
+        else if (action == DEADLINE_ACTION_RECOVER && tl_settings.is_fault_mode)
         {
-            stop_tone(BUZZER_B_PIN); // Garante que o buzzer B está parado
+            // Controle dentro do prazo desde a falha: volta ao modo anterior pela fase veicular
+            tl_settings.is_fault_mode = false;
+            tl_settings.is_night_mode = was_night_mode;
+            light_state = was_night_mode ? 1 : 2;
+            publish_phase();
+            apply_power_profile();
+            LOG1(LOG_FAULT_RECOVERED, DEADLINE_RECOVERY_MS);
+        }
 
-            play_tone(BUZZER_A_PIN, 150); // Liga buzzer A
-            for (int i = 0; i < 20; i++) // Espera 2 segundos em fatias de 100ms
+        xip_profiler_sample(); // Bem antes da volta dos contadores de 32 bits
+        task_delay_ms(TASK_DEADLINE_MONITOR, MONITOR_PERIOD_MS);
+    }
+}
+
+// Relatórios periódicos na menor prioridade do plano: o printf não atrasa o monitor nem as saídas.
+void vReportTask()
+{
+    deadline_job_begin(TASK_REPORT);
+    while (true)
+    {
+        uint32_t bits = task_wait_notify(TASK_REPORT, MONITOR_REPORT_MS);
+
+        deadline_monitor_report();
+        if (bits & REPORT_NOTIFY_FAULT)
+            continue;
+
+        timebase_report();
+        power_report();
+        xip_profiler_report();
+        detector_report();
+        cyclelog_report();
+        status_report();
+        if (tl_settings.is_coordinated_mode)
+            coord_report();
+    }
+}
+
+void vStackProfilerTask()
+{
+    uint32_t last_report = to_ms_since_boot(get_absolute_time());
+
+    while (true)
+    {
+        stack_profiler_sample();
+
+        uint32_t now = to_ms_since_boot(get_absolute_time());
+        if (now - last_report >= STACK_PROFILER_REPORT_MS)
+        {
+            stack_profiler_report();
+            last_report = now;
+        }
+        vTaskDelay(pdMS_TO_TICKS(STACK_PROFILER_SAMPLE_MS));
+    }
+}
+
+void vLogDrainTask()
+{
+    char command[HOST_COMMAND_MAX];
+    uint8_t command_length = 0;
+
+    deadline_job_begin(TASK_LOG_DRAIN);
+    while (true)
+    {
+        log_drain();
+
+        // Comandos do host chegam como linhas de texto, lidas sem bloquear
+        int c;
+        while ((c = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT)
+        {
+            if (c == '\n' || c == '\r')
             {
-                if (!tl_settings.is_night_mode) break;
-                vTaskDelay(pdMS_TO_TICKS(100));
+                command[command_length] = '\0';
+                if (command_length)
+                    run_host_command(command);
+                command_length = 0;
             }
-
-            stop_tone(BUZZER_A_PIN); // Desliga buzzer A
-            for (int i = 0; i < 20; i++) // Espera mais 2 segundos em fatias
+            else if (command_length < sizeof(command) - 1)
             {
-                if (!tl_settings.is_night_mode) break;
-                vTaskDelay(pdMS_TO_TICKS(100));
+                command[command_length++] = (char)c;
             }
         }
-        else
-        {
-            stop_tone(BUZZER_A_PIN); // Garante que o buzzer A está parado
 
-            int freq = tl_settings.buzzer_frequency[light_state];
-            int active_time = tl_settings.buzzer_active_time[light_state];
-            int inactive_time = tl_settings.buzzer_inactive_time[light_state];
+        status_service();  // Tópicos assinados codificados direto no buffer de transmissão
+        status_transmit();
+        cyclelog_stream_step(); // Algumas páginas por período, intercaladas com o log
+        task_delay_ms(TASK_LOG_DRAIN, LOG_DRAIN_PERIOD_MS);
+    }
+}
 
-            play_tone(BUZZER_B_PIN, freq);
-            for (int i = 0; i < active_time / 50; i++) {
-                if (tl_settings.is_night_mode) break;
-                vTaskDelay(pdMS_TO_TICKS(50));
-            }
+// Comandos do host:
+// "ciclos [boot] [de_ms ate_ms]": envia o registro de ciclos (todos os boots se omitido).
+// "assinar <topico> [intervalo_ms]" e "cancelar <topico>": assinaturas do fluxo de estado.
+// "eco <n>": devolve n em um quadro de estado, para o host medir o atraso do enlace.
+void run_host_command(const char *line)
+{
+    char topic[16];
+    unsigned int value;
+    int fields = sscanf(line, "assinar %15s %u", topic, &value);
+    if (fields >= 1)
+    {
+        status_subscribe(status_topic_from_name(topic), fields >= 2 ? value : 0);
+        return;
+    }
+    if (sscanf(line, "cancelar %15s", topic) == 1)
+    {
+        status_unsubscribe(status_topic_from_name(topic));
+        return;
+    }
+    if (sscanf(line, "eco %u", &value) == 1)
+    {
+        status_echo(value);
+        return;
+    }
+    if (strncmp(line, "ciclos", 6) != 0)
+        return;
 
-            stop_tone(BUZZER_B_PIN);
-            for (int i = 0; i < inactive_time / 50; i++) {
-                if (tl_settings.is_night_mode) break;
-                vTaskDelay(pdMS_TO_TICKS(50));
-            }
-        }
+    unsigned int boot, from_ms, to_ms;
+    fields = sscanf(line, "ciclos %u %u %u", &boot, &from_ms, &to_ms);
+    if (fields >= 3)
+        cyclelog_stream_begin(boot, from_ms, to_ms);
+    else if (fields >= 1)
+        cyclelog_stream_begin(boot, 0, UINT32_MAX);
+    else
+        cyclelog_stream_begin(CYCLELOG_ANY_BOOT, 0, UINT32_MAX);
+}
+
+// Cada subida aceita em um laço conta como detecção veicular no modo atuado.
+void on_detector_edge(void *context, uint8_t channel, bool occupied, uint64_t time_us)
+{
+    if (occupied && tl_settings.is_adaptive_mode)
+        adaptive_count(ADAPTIVE_APPROACH_VEHICLE + channel); // Um veículo por ocupação do laço
+    else if (occupied)
+        actuation_vehicle_call(to_ms_since_boot(get_absolute_time()));
+}
+
+void vDetectorTask()
+{
+    deadline_job_begin(TASK_DETECTOR);
+    while (true)
+    {
+        // Processa em lote as amostras que o DMA acumulou; a captura não gera interrupções
+        detector_poll();
+
+        // Um veículo parado sobre o laço continua prolongando a fase veicular
+        if (detector_occupied_mask())
+            actuation_vehicle_call(to_ms_since_boot(get_absolute_time()));
+
+        task_delay_ms(TASK_DETECTOR, DETECTOR_BATCH_MS);
+    }
+}
+
+void vCycleLogTask()
+{
+    deadline_job_begin(TASK_CYCLELOG);
+    while (true)
+    {
+        cyclelog_service(); // Grava uma página ou apaga um setor quando há folga
+        task_delay_ms(TASK_CYCLELOG, CYCLELOG_SERVICE_MS);
     }
 }
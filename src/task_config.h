@@ -0,0 +1,76 @@
+#ifndef TASK_CONFIG_H
+#define TASK_CONFIG_H
+
+// Tamanhos de pilha das tarefas (em palavras de 32 bits).
+// Estimativas, ainda sem medição no alvo: 256 palavras (o configMINIMAL_STACK_SIZE anterior) para
+// tarefas sem printf nem buffers locais, 192 para o buzzer, que só alterna o PWM, e 512 para as que
+// passam pelo printf/sscanf do SDK, guardam estruturas grandes na pilha ou publicam a fase e trocam o
+// perfil de energia (set_sys_clock_khz e os observadores de clock; as três tarefas que fazem isso
+// recebem o mesmo tamanho, já que o caminho mais profundo é o mesmo). Um estouro não passa
+// despercebido: configCHECK_FOR_STACK_OVERFLOW 2 encerra com panic nomeando a tarefa. Para medir,
+// compile com -DSTACK_PROFILING=ON e, após uma execução longa em todos os modos, substitua estas
+// linhas pelas definições "#define ..." do relatório (pico medido mais 25%, múltiplo de 32).
+#define DISPLAY_TASK_STACK_SIZE 512               // ssd1306_t, buffer de sprintf e caminho do printf
+#define LED_MATRIX_TASK_STACK_SIZE 256
+#define MODE_TOGGLE_TASK_STACK_SIZE 512           // Modo noturno: publicação de fase e troca de perfil
+#define TRAFFIC_LIGHT_CONTROL_TASK_STACK_SIZE 512 // Publicação de fase; no modo adaptativo, webster_update
+#define BUZZER_TASK_STACK_SIZE 192
+#define DEADLINE_MONITOR_TASK_STACK_SIZE 512      // Modo de segurança: publicação de fase e troca de perfil
+#define STACK_PROFILER_TASK_STACK_SIZE 512        // printf do relatório de pilhas
+#define LOG_DRAIN_TASK_STACK_SIZE 512             // fwrite dos quadros de log e sscanf dos comandos do host
+#define DETECTOR_TASK_STACK_SIZE 256
+#define CYCLELOG_TASK_STACK_SIZE 256
+#define REPORT_TASK_STACK_SIZE 512                // printf dos relatórios periódicos
+
+// No modo de perfilamento todas as tarefas recebem a mesma pilha generosa,
+// para que o pico medido não seja limitado pelo tamanho atual.
+#ifdef STACK_PROFILING
+#define STACK_PROFILING_STACK_SIZE 1024
+#define TASK_STACK_SIZE(size) STACK_PROFILING_STACK_SIZE
+#else
+#define TASK_STACK_SIZE(size) (size)
+#endif
+
+#define STACK_PROFILER_SAMPLE_MS 500   // Período de amostragem das marcas d'água
+#define STACK_PROFILER_REPORT_MS 60000 // Intervalo entre relatórios do perfilador
+
+// Plano de tarefas: X(id, função, nome, pilha, período_ms, intervalo_max_ms, wcet_us, prazo_ms, bloqueio_us, crítica).
+// - período: menor intervalo entre liberações; define a prioridade por taxa monotônica (menor período,
+//   maior prioridade; empates pelo menor prazo e depois pela ordem da tabela).
+// - intervalo_max: maior intervalo entre liberações, usado pelo monitor para detectar travamentos.
+// - wcet: orçamento de execução de um job. Os valores abaixo são estimativas, ainda não medidas no
+//   alvo, e a análise só vale para eles. Substitua-os pela coluna wcet_recomendado_us do relatório
+//   de prazos (execução máxima medida mais 25%) após uma execução longa em todos os modos.
+// - prazo: tempo máximo de resposta verificado pelo monitor (0: apenas medida; a análise usa o período).
+// - bloqueio: maior trecho do job com interrupções desligadas ou com o mutex do stdout, que atrasa
+//   tarefas de prioridade maior. Seções críticas abaixo de 50 us são desprezadas. O registro de
+//   ciclos declara o pior caso da flash: programar uma página ou uma fatia do apagamento de setor.
+// tools/rta.py lê esta tabela, repete a atribuição de prioridades e falha o build se o conjunto
+// não for escalonável.
+#define TASK_TABLE(X)                                                                                          \
+    /* Uma fase por período: desenho antes da fronteira e envio na efetivação */                              \
+    X(TASK_DISPLAY, vDisplayTask, "Display OLED", DISPLAY_TASK_STACK_SIZE, TRAFFIC_LIGHT_DELAY_MS,            \
+      OUTPUT_IDLE_TIMEOUT_MS, 25000, 100, 0, false)                                                           \
+    X(TASK_LED_MATRIX, vLedMatrixTask, "Matriz de Led", LED_MATRIX_TASK_STACK_SIZE, ANIMATION_FRAME_US / 1000, \
+      ANIMATION_FRAME_US / 1000, 2500, 10, 0, false)                                                          \
+    X(TASK_MODE_TOGGLE, vModeToggleTask, "Mudar modo", MODE_TOGGLE_TASK_STACK_SIZE, 10, 10, 100, 20, 0,       \
+      false)                                                                                                  \
+    /* Menor espera: o passo do modo atuado */                                                                \
+    X(TASK_TRAFFIC_LIGHT_CONTROL, vTrafficLightControlTask, "Controle do Semáforo",                           \
+      TRAFFIC_LIGHT_CONTROL_TASK_STACK_SIZE, ACTUATION_TICK_MS, TRAFFIC_LIGHT_DELAY_MS, 500, 100, 0, true)    \
+    /* Menor trecho do padrão (amarelo) e maior intervalo sem notificação */                                  \
+    X(TASK_BUZZER, vBuzzerTask, "Buzzer", BUZZER_TASK_STACK_SIZE, 250, TRAFFIC_LIGHT_DELAY_MS, 200, 20, 0,     \
+      false)                                                                                                  \
+    X(TASK_DEADLINE_MONITOR, vDeadlineMonitorTask, "Monitor de Prazos", DEADLINE_MONITOR_TASK_STACK_SIZE,     \
+      MONITOR_PERIOD_MS, MONITOR_PERIOD_MS, 500, 0, 0, false)                                                 \
+    X(TASK_LOG_DRAIN, vLogDrainTask, "Log USB", LOG_DRAIN_TASK_STACK_SIZE, LOG_DRAIN_PERIOD_MS,               \
+      LOG_DRAIN_PERIOD_MS, 3000, 100, 500, false)                                                             \
+    X(TASK_DETECTOR, vDetectorTask, "Detector", DETECTOR_TASK_STACK_SIZE, DETECTOR_BATCH_MS,                  \
+      DETECTOR_BATCH_MS, 1000, 10, 0, false)                                                                  \
+    /* Programa uma página ou apaga uma fatia de setor com interrupções desligadas, na folga entre fases */   \
+    X(TASK_CYCLELOG, vCycleLogTask, "Registro de Ciclos", CYCLELOG_TASK_STACK_SIZE, CYCLELOG_SERVICE_MS,      \
+      CYCLELOG_SERVICE_MS, 3500, 0, CYCLELOG_BLOCKING_US, false)                                              \
+    X(TASK_REPORT, vReportTask, "Relatorios", REPORT_TASK_STACK_SIZE, MONITOR_REPORT_MS, MONITOR_REPORT_MS,   \
+      60000, 0, 1000, false)
+
+#endif // TASK_CONFIG_H
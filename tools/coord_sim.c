@@ -0,0 +1,261 @@
+// Simulador da coordenação em onda verde no Linux.
+//
+// Monta uma cadeia de controladores em que cada enlace UART é um pseudo-terminal (ou um pipe,
+// com --pipe): o nó i escreve seus quadros de sincronismo no mestre do pty e o nó i + 1 os lê do
+// escravo, byte a byte, com o mesmo decodificador e o mesmo servo de fase do firmware
+// (lib/coord/coord_core.c). Cada nó tem um relógio próprio, com instante de boot e deriva (ppm)
+// diferentes; o tempo é simulado por eventos, então milhares de ciclos rodam em segundos.
+//
+// Mede, para cada nó, o erro entre o início do seu ciclo e o início ideal
+// (ciclo do líder + soma das defasagens a montante).
+//
+// Compilação e uso:
+//   cc -O2 -Ilib/coord -o coord_sim tools/coord_sim.c lib/coord/coord_core.c -lutil
+//   ./coord_sim [--nodes 5] [--cycles 2000] [--offset-ms 1500] [--ppm 100] [--jitter-us 100] [--pipe]
+
+#define _DEFAULT_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <pty.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "coord_core.h"
+
+#define MAX_NODES 16
+#define BAUD 115200
+#define CYCLE_US 6000000u   // 3 estados de TRAFFIC_LIGHT_DELAY_MS
+#define SETTLE_CYCLES 20    // Ciclos ignorados nas estatísticas (aquisição da trava)
+
+typedef struct node_t
+{
+    coord_engine_t engine;
+    coord_decoder_t decoder;
+    double ppm;             // Deriva do oscilador local
+    double boot_us;         // Instante real do boot (relógio local começa em 0)
+    int link_write;         // Descritor para o nó seguinte (-1 no último)
+    int link_read;          // Descritor vindo do nó anterior (-1 no líder)
+    double pending_rx_true; // Instante real em que o quadro a montante termina de chegar (<0: nenhum)
+    double ideal_offset_us; // Soma das defasagens até este nó (no relógio do líder)
+    // Estatísticas de erro em relação ao início ideal
+    uint32_t samples;
+    double sum_abs_error_us;
+    double max_abs_error_us;
+} node_t;
+
+static node_t nodes[MAX_NODES];
+static int node_count = 5;
+
+static double local_to_true(const node_t *node, uint64_t local_us)
+{
+    return node->boot_us + local_us / (1.0 + node->ppm * 1e-6);
+}
+
+static uint64_t true_to_local(const node_t *node, double true_us)
+{
+    return (uint64_t)((true_us - node->boot_us) * (1.0 + node->ppm * 1e-6));
+}
+
+// Cria o enlace entre dois nós: pty em modo raw (padrão) ou pipe.
+static void open_link(bool use_pipe, int *write_fd, int *read_fd)
+{
+    int fds[2];
+    if (use_pipe)
+    {
+        if (pipe(fds) < 0)
+        {
+            perror("pipe");
+            exit(1);
+        }
+        *read_fd = fds[0];
+        *write_fd = fds[1];
+    }
+    else
+    {
+        struct termios raw;
+        cfmakeraw(&raw);
+        cfsetspeed(&raw, B115200);
+        if (openpty(&fds[0], &fds[1], NULL, &raw, NULL) < 0)
+        {
+            perror("openpty");
+            exit(1);
+        }
+        *write_fd = fds[0]; // Mestre: o lado "UART TX" do nó a montante
+        *read_fd = fds[1];  // Escravo: o lado "UART RX" do nó a jusante
+    }
+    fcntl(*read_fd, F_SETFL, O_NONBLOCK);
+}
+
+static double frame_time_us()
+{
+    return COORD_FRAME_SIZE * 10 * 1e6 / BAUD;
+}
+
+static double jitter(double max_us)
+{
+    return max_us * rand() / RAND_MAX;
+}
+
+// Início de ciclo de um nó: mede o erro, avança o motor e repassa o sincronismo.
+static void on_cycle_start(int index, double now_true, double jitter_us)
+{
+    node_t *node = &nodes[index];
+    coord_engine_advance(&node->engine);
+
+    if (index > 0 && node->engine.cycle > SETTLE_CYCLES)
+    {
+        // Início ideal: início do líder mais próximo + defasagem acumulada, ambos no relógio do líder
+        // (o corredor inteiro segue o oscilador do líder). A defasagem acumulada pode passar de um ciclo.
+        double leader_cycle = CYCLE_US / (1.0 + nodes[0].ppm * 1e-6);
+        double ideal = local_to_true(&nodes[0], nodes[0].engine.cycle_start_us + node->ideal_offset_us);
+        double error = now_true - ideal;
+        error -= leader_cycle * (long)(error / leader_cycle + (error < 0 ? -0.5 : 0.5));
+        double abs_error = error < 0 ? -error : error;
+        node->samples++;
+        node->sum_abs_error_us += abs_error;
+        if (abs_error > node->max_abs_error_us)
+            node->max_abs_error_us = abs_error;
+    }
+
+    if (node->link_write < 0 || !coord_engine_should_emit(&node->engine))
+        return;
+
+    // O envio sai da tarefa de controle com algum atraso em relação ao início do ciclo.
+    double tx_true = now_true + jitter(jitter_us);
+    coord_sync_t sync;
+    uint8_t frame[COORD_FRAME_SIZE];
+    coord_engine_make_sync(&node->engine, true_to_local(node, tx_true), &sync);
+    uint8_t length = coord_encode(&sync, frame);
+    if (write(node->link_write, frame, length) != length)
+    {
+        perror("write");
+        exit(1);
+    }
+    nodes[index + 1].pending_rx_true = tx_true + frame_time_us() + jitter(jitter_us);
+}
+
+// Fim da recepção de um quadro: lê os bytes do enlace e entrega ao servo com o carimbo local.
+static void on_frame_received(int index, double now_true)
+{
+    node_t *node = &nodes[index];
+    node->pending_rx_true = -1;
+
+    uint8_t buffer[64];
+    ssize_t count;
+    while ((count = read(node->link_read, buffer, sizeof(buffer))) > 0)
+    {
+        for (ssize_t i = 0; i < count; i++)
+        {
+            coord_sync_t sync;
+            if (coord_decode_byte(&node->decoder, buffer[i], &sync))
+                coord_engine_on_sync(&node->engine, &sync, true_to_local(node, now_true));
+        }
+    }
+    if (count < 0 && errno != EAGAIN)
+    {
+        perror("read");
+        exit(1);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t cycles = 2000;
+    double offset_ms = 1500, ppm = 100, jitter_us = 100;
+    bool use_pipe = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--nodes") && i + 1 < argc)
+            node_count = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--cycles") && i + 1 < argc)
+            cycles = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--offset-ms") && i + 1 < argc)
+            offset_ms = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--ppm") && i + 1 < argc)
+            ppm = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--jitter-us") && i + 1 < argc)
+            jitter_us = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--pipe"))
+            use_pipe = true;
+        else
+        {
+            fprintf(stderr, "uso: %s [--nodes N] [--cycles N] [--offset-ms MS] [--ppm PPM] [--jitter-us US] [--pipe]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if (node_count < 2 || node_count > MAX_NODES)
+    {
+        fprintf(stderr, "--nodes deve estar entre 2 e %d\n", MAX_NODES);
+        return 2;
+    }
+
+    srand(1);
+    for (int i = 0; i < node_count; i++)
+    {
+        node_t *node = &nodes[i];
+        coord_config_t config = {
+            .cycle_length_us = CYCLE_US,
+            .offset_us = (int32_t)(offset_ms * 1000),
+            .link_delay_us = (uint32_t)frame_time_us(),
+            .kp_q8 = 128,
+            .ki_q8 = 32,
+            .step_threshold_us = CYCLE_US / 10,
+            .max_slew_us = CYCLE_US / 100,
+            .holdover_cycles = 5,
+        };
+        node->ppm = ppm * (2.0 * rand() / RAND_MAX - 1.0);
+        node->boot_us = jitter(CYCLE_US);
+        node->ideal_offset_us = i * offset_ms * 1000;
+        node->pending_rx_true = -1;
+        node->link_write = node->link_read = -1;
+        coord_decoder_reset(&node->decoder);
+        coord_engine_init(&node->engine, &config, i == 0, 0);
+    }
+    for (int i = 0; i + 1 < node_count; i++)
+        open_link(use_pipe, &nodes[i].link_write, &nodes[i + 1].link_read);
+
+    // Laço de eventos: o próximo início de ciclo ou fim de recepção, em tempo real simulado.
+    while (nodes[0].engine.cycle < cycles)
+    {
+        int next = -1;
+        bool is_rx = false;
+        double next_true = 0;
+        for (int i = 0; i < node_count; i++)
+        {
+            double start = local_to_true(&nodes[i], coord_engine_next_start(&nodes[i].engine));
+            if (next < 0 || start < next_true)
+            {
+                next = i;
+                next_true = start;
+                is_rx = false;
+            }
+            if (nodes[i].pending_rx_true >= 0 && nodes[i].pending_rx_true < next_true)
+            {
+                next = i;
+                next_true = nodes[i].pending_rx_true;
+                is_rx = true;
+            }
+        }
+
+        if (is_rx)
+            on_frame_received(next, next_true);
+        else
+            on_cycle_start(next, next_true, jitter_us);
+    }
+
+    printf("no;salto;deriva_ppm;travado;saltos;perdas;erro_medio_us;erro_max_us;trim_us\n");
+    for (int i = 0; i < node_count; i++)
+    {
+        node_t *node = &nodes[i];
+        double mean = node->samples ? node->sum_abs_error_us / node->samples : 0;
+        printf("%d;%u;%.1f;%s;%lu;%lu;%.1f;%.1f;%ld\n", i, i == 0 ? 0 : node->engine.hop, node->ppm,
+               i == 0 ? "lider" : (node->engine.is_locked ? "sim" : "nao"), (unsigned long)node->engine.stats.steps,
+               (unsigned long)node->engine.stats.lost, mean, node->max_abs_error_us, (long)node->engine.stats.trim_us);
+    }
+    return 0;
+}
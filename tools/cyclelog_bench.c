@@ -0,0 +1,145 @@
+// Volume do registro de ciclos no Linux.
+//
+// Gera uma sequência de ciclos, codifica-os em páginas com o mesmo codec do firmware
+// (lib/cyclelog/cyclelog_codec.c), decodifica cada página selada e confere cada campo com o ciclo
+// original. Imprime os bytes codificados por ciclo (ocupação das páginas) e os bytes de flash por
+// ciclo (páginas inteiras, como são gravadas), que determinam quantos ciclos cabem na região.
+//
+// Cenários:
+//   fixo:   tempo fixo, verde, amarelo e vermelho de 2000 ms; a cada 50 ciclos o vermelho dura
+//           1 ms a mais (deriva do agendamento), sem chamadas nem veículos.
+//   atuado: verde e amarelo de 2000 a 2029 ms, vermelho de 3 a 23 s, 1 ou 2 chamadas de pedestre,
+//           0 a 11 veículos e uma perda de prazo a cada ~200 ciclos, sorteados.
+// Nos dois, o modo noturno é ligado no ciclo 700 (uma troca de modos).
+//
+// Compilação e uso:
+//   cc -O2 -Ilib/cyclelog -o cyclelog_bench tools/cyclelog_bench.c lib/cyclelog/cyclelog_codec.c
+//   ./cyclelog_bench [--scenario fixo|atuado] [--cycles 2000] [--seed 3]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cyclelog_codec.h"
+
+#define NIGHT_CYCLE 700
+
+static cyclelog_record_t make_cycle(int index, uint32_t start_ms, bool is_actuated)
+{
+    cyclelog_record_t record = {.start_ms = start_ms, .flags = is_actuated ? CYCLELOG_FLAG_ACTUATED : 0};
+    if (is_actuated)
+    {
+        record.phase_ms[0] = 2000 + rand() % 30;
+        record.phase_ms[1] = 2000 + rand() % 30;
+        record.phase_ms[2] = 3000 + rand() % 20000;
+        record.pedestrian_calls = 1 + rand() % 2;
+        record.vehicles = rand() % 12;
+        record.misses = rand() % 200 == 0;
+    }
+    else
+    {
+        record.phase_ms[0] = record.phase_ms[1] = record.phase_ms[2] = 2000;
+        if (index % 50 == 0)
+            record.phase_ms[2]++;
+    }
+    if (index == NIGHT_CYCLE)
+        record.flags |= CYCLELOG_FLAG_NIGHT;
+    return record;
+}
+
+static bool same_record(const cyclelog_record_t *a, const cyclelog_record_t *b)
+{
+    return a->start_ms == b->start_ms && !memcmp(a->phase_ms, b->phase_ms, sizeof(a->phase_ms)) &&
+           a->flags == b->flags && a->misses == b->misses && a->pedestrian_calls == b->pedestrian_calls &&
+           a->vehicles == b->vehicles;
+}
+
+// Sela a página, confere a decodificação com os ciclos originais e acumula o volume.
+static bool check_page(cyclelog_page_t *page, uint32_t sequence, const cyclelog_record_t *expected,
+                       uint32_t *used_bytes)
+{
+    static cyclelog_record_t decoded[CYCLELOG_PAGE_SIZE];
+    cyclelog_page_info_t info;
+
+    cyclelog_page_seal(page, 0, sequence);
+    if (!cyclelog_page_parse(page->data, &info) || !cyclelog_page_decode(page->data, decoded, info.count))
+    {
+        fprintf(stderr, "página %u: falha ao decodificar\n", sequence);
+        return false;
+    }
+    for (uint8_t i = 0; i < info.count; i++)
+    {
+        if (!same_record(&decoded[i], &expected[i]))
+        {
+            fprintf(stderr, "página %u: ciclo %u decodificado diferente do original\n", sequence, i);
+            return false;
+        }
+    }
+    *used_bytes += page->used;
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    const char *scenario = "fixo";
+    int cycles = 2000;
+    unsigned seed = 3;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--scenario") && i + 1 < argc)
+            scenario = argv[++i];
+        else if (!strcmp(argv[i], "--cycles") && i + 1 < argc)
+            cycles = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--seed") && i + 1 < argc)
+            seed = strtoul(argv[++i], NULL, 10);
+        else
+        {
+            fprintf(stderr, "uso: %s [--scenario fixo|atuado] [--cycles N] [--seed N]\n", argv[0]);
+            return 2;
+        }
+    }
+    bool is_actuated = !strcmp(scenario, "atuado");
+    if ((!is_actuated && strcmp(scenario, "fixo")) || cycles < 1)
+    {
+        fprintf(stderr, "cenário deve ser fixo ou atuado e --cycles maior que zero\n");
+        return 2;
+    }
+
+    srand(seed);
+    static cyclelog_record_t pending[CYCLELOG_PAGE_SIZE]; // Ciclos da página em preenchimento
+    uint8_t pending_count = 0;
+    uint32_t pages = 0, used_bytes = 0, start_ms = 1000;
+
+    cyclelog_page_t page;
+    cyclelog_base_t base = {.start_ms = start_ms};
+    cyclelog_page_open(&page, &base);
+    for (int i = 0; i < cycles; i++)
+    {
+        cyclelog_record_t record = make_cycle(i, start_ms, is_actuated);
+        start_ms += record.phase_ms[0] + record.phase_ms[1] + record.phase_ms[2];
+
+        if (!cyclelog_page_append(&page, &record))
+        {
+            // Página cheia: o ciclo vai para a próxima, como em append_record no firmware
+            if (!check_page(&page, pages++, pending, &used_bytes))
+                return 1;
+            base = page.base;
+            cyclelog_page_open(&page, &base);
+            pending_count = 0;
+            if (!cyclelog_page_append(&page, &record))
+            {
+                fprintf(stderr, "ciclo %d não cabe em uma página vazia\n", i);
+                return 1;
+            }
+        }
+        pending[pending_count++] = record;
+    }
+    if (pending_count && !check_page(&page, pages++, pending, &used_bytes))
+        return 1;
+
+    printf("cenario;ciclos;paginas;bytes_por_ciclo;flash_por_ciclo\n");
+    printf("%s;%d;%u;%.2f;%.2f\n", scenario, cycles, pages, (double)used_bytes / cycles,
+           (double)pages * CYCLELOG_PAGE_SIZE / cycles);
+    return 0;
+}
@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+"""Lê o registro de ciclos gravado na flash do semáforo e o converte em CSV.
+
+Reconhece os quadros do canal do registro de ciclos no fluxo da USB CDC
+(ou em um arquivo gravado dele), remonta as páginas de 256 bytes e as
+decodifica como lib/cyclelog/cyclelog_codec.c. Se a origem for a porta
+serial, envia antes o comando de leitura ("ciclos [boot] [de_ms ate_ms]").
+Com --pages, lê um arquivo de páginas cruas (ex.: cópia da região da flash).
+
+Uso: tools/cyclelog_decode.py /dev/ttyACM0 [--boot N] [--de MS --ate MS]
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+from log_decode import FRAME_SYNC, crc8
+
+CYCLELOG_CHANNEL = 0x03
+PAGE_SIZE = 256
+PAGE_MAGIC = 0xC1C7
+HEADER_SIZE = 37
+END_SEQUENCE = 0xFFFFFFFF
+FLAGS = ((1, "noturno"), (2, "falha"), (4, "atuado"), (8, "coordenado"), (16, "adaptativo"))
+
+
+def unzigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def read_varint(data, position, end):
+    value = 0
+    for shift in range(0, 35, 7):
+        if position >= end:
+            break
+        byte = data[position]
+        position += 1
+        value |= (byte & 0x7F) << shift
+        if not byte & 0x80:
+            return value, position
+    raise ValueError("varint truncado")
+
+
+def parse_page(data):
+    """Valida o cabeçalho e o CRC; retorna (boot, sequência, contagem, usados) ou None."""
+    magic, boot, sequence, count, crc, used = struct.unpack_from("<HHIBBH", data)
+    if magic != PAGE_MAGIC or not HEADER_SIZE <= used <= PAGE_SIZE:
+        return None
+    if crc8(data[:9] + data[10:used]) != crc:
+        return None
+    return boot, sequence, count, used
+
+
+def decode_page(data):
+    """Retorna as entradas da página como dicionários (mesma lógica de cyclelog_page_decode)."""
+    header = parse_page(data)
+    if header is None:
+        return None
+    boot, sequence, count, used = header
+    start, _, interval = struct.unpack_from("<III", data, 12)
+    phases = list(struct.unpack_from("<III", data, 24))
+    flags = data[36]
+
+    records = []
+    position = HEADER_SIZE
+    for _ in range(count):
+        mask = data[position]
+        position += 1
+        fields = [0] * 8
+        for i in range(8):
+            if mask & (1 << i):
+                fields[i], position = read_varint(data, position, used)
+        interval = (interval + unzigzag(fields[0])) & 0xFFFFFFFF
+        start = (start + interval) & 0xFFFFFFFF
+        phases = [(p + unzigzag(d)) & 0xFFFFFFFF for p, d in zip(phases, fields[1:4])]
+        flags ^= fields[4]
+        records.append({
+            "boot": boot, "pagina": sequence, "inicio_ms": start, "verde_ms": phases[0],
+            "amarelo_ms": phases[1], "vermelho_ms": phases[2],
+            "modos": "+".join(name for bit, name in FLAGS if flags & bit) or "fixo",
+            "perdas": fields[5], "pedestres": fields[6], "veiculos": fields[7],
+        })
+    return records
+
+
+def collect_pages(stream):
+    """Remonta as páginas a partir das metades; termina no quadro final."""
+    halves = {}
+    pages = {}
+    buffer = bytearray()
+    while True:
+        chunk = stream.read(512)
+        if not chunk:
+            break
+        buffer += chunk
+        while True:
+            start = buffer.find(bytes([FRAME_SYNC]))
+            if start < 0:
+                buffer.clear()
+                break
+            del buffer[:start]
+            if len(buffer) < 3 or len(buffer) < 3 + buffer[2] + 1:
+                break
+            channel, length = buffer[1], buffer[2]
+            payload = bytes(buffer[3:3 + length])
+            if crc8(payload) != buffer[3 + length]:
+                del buffer[:1]  # Byte de texto igual ao sincronismo
+                continue
+            del buffer[:3 + length + 1]
+            if channel != CYCLELOG_CHANNEL or length < 5:
+                continue
+            sequence, part = struct.unpack_from("<IB", payload)
+            if sequence == END_SEQUENCE:
+                return [pages[s] for s in sorted(pages)]
+            halves.setdefault(sequence, {})[part] = payload[5:]
+            if len(halves[sequence]) == 2:
+                parts = halves.pop(sequence)
+                pages[sequence] = parts[0] + parts[1]
+    return [pages[s] for s in sorted(pages)]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("source", help="porta serial (ex.: /dev/ttyACM0) ou arquivo gravado")
+    parser.add_argument("--pages", action="store_true", help="a origem é um arquivo de páginas cruas")
+    parser.add_argument("--boot", type=int, help="apenas este boot")
+    parser.add_argument("--de", type=int, default=0, help="início do intervalo (ms desde o boot)")
+    parser.add_argument("--ate", type=int, default=0xFFFFFFFF, help="fim do intervalo (ms desde o boot)")
+    args = parser.parse_args()
+
+    with open(args.source, "rb", buffering=0) as stream:
+        if args.pages:
+            raw = stream.read()
+            pages = [raw[i:i + PAGE_SIZE] for i in range(0, len(raw) - PAGE_SIZE + 1, PAGE_SIZE)]
+        else:
+            if os.isatty(stream.fileno()):
+                command = "ciclos"
+                if args.boot is not None:
+                    command += " %d %d %d" % (args.boot, args.de, args.ate)
+                os.write(stream.fileno(), (command + "\n").encode())
+            pages = collect_pages(stream)
+
+    columns = ("boot", "pagina", "inicio_ms", "verde_ms", "amarelo_ms", "vermelho_ms", "modos", "perdas",
+               "pedestres", "veiculos")
+    print(";".join(columns))
+    cycles = used_bytes = valid_pages = 0
+    for page in sorted(pages, key=lambda p: struct.unpack_from("<I", p, 4)[0]):
+        records = decode_page(page)
+        if records is None:
+            continue
+        valid_pages += 1
+        used_bytes += parse_page(page)[3]
+        for record in records:
+            if args.boot is not None and record["boot"] != args.boot:
+                continue
+            if not args.de <= record["inicio_ms"] <= args.ate:
+                continue
+            cycles += 1
+            print(";".join(str(record[c]) for c in columns))
+
+    if cycles:
+        print("# %d ciclos em %d paginas: %.2f bytes codificados e %.2f bytes de flash por ciclo"
+              % (cycles, valid_pages, used_bytes / cycles, valid_pages * PAGE_SIZE / cycles), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,312 @@
+// Reprodução de trens de pulsos dos detectores veiculares no Linux.
+//
+// Converte uma lista de bordas em palavras de amostras idênticas às que a PIO escreve no buffer
+// circular (32 / canais amostras por palavra, a mais antiga nos bits altos) e as entrega em lotes
+// de tamanho variável ao mesmo núcleo do firmware (lib/detector/detector_core.c), como faz a
+// tarefa do detector. Imprime contagem, ocupação e headway por canal e o custo por palavra no host.
+//
+// As bordas vêm de um arquivo (uma por linha: "tempo_us canal nível", separados por espaço ou
+// vírgula, '#' inicia comentário; o formato de exportação de um analisador lógico) ou são geradas:
+// cada canal recebe pulsos periódicos com frequência e ciclo de trabalho dados e, opcionalmente,
+// pulsos espúrios mais curtos que o filtro. No modo gerado, o resultado é comparado com o esperado.
+//
+// Compilação e uso:
+//   cc -O2 -Ilib/detector -o detector_replay tools/detector_replay.c lib/detector/detector_core.c
+//   ./detector_replay [--channels 4] [--rate-hz 1000] [--duty 30] [--glitches 5] [--seconds 10]
+//                     [--sample-us 10] [--filter-us 50] [--batch-ms 20] [--write bordas.txt]
+//   ./detector_replay --file bordas.txt [--channels 4] [--sample-us 10] [--filter-us 50]
+
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "detector_core.h"
+
+typedef struct edge_t
+{
+    uint64_t time_us;
+    uint8_t channel;
+    uint8_t level;
+} edge_t;
+
+static edge_t *edges = NULL;
+static size_t edge_count = 0;
+static size_t edge_capacity = 0;
+
+static void add_edge(uint64_t time_us, uint8_t channel, uint8_t level)
+{
+    if (edge_count == edge_capacity)
+    {
+        edge_capacity = edge_capacity ? edge_capacity * 2 : 4096;
+        edges = realloc(edges, edge_capacity * sizeof(edge_t));
+        if (!edges)
+        {
+            perror("realloc");
+            exit(1);
+        }
+    }
+    edges[edge_count++] = (edge_t){time_us, channel, level};
+}
+
+static int compare_edges(const void *a, const void *b)
+{
+    const edge_t *ea = a, *eb = b;
+    if (ea->time_us != eb->time_us)
+        return ea->time_us < eb->time_us ? -1 : 1;
+    return (int)ea->channel - (int)eb->channel;
+}
+
+static int load_edges(const char *path, uint8_t channels)
+{
+    FILE *file = fopen(path, "r");
+    if (!file)
+    {
+        perror(path);
+        return -1;
+    }
+
+    char line[128];
+    unsigned line_number = 0;
+    while (fgets(line, sizeof(line), file))
+    {
+        line_number++;
+        char *comment = strchr(line, '#');
+        if (comment)
+            *comment = '\0';
+        for (char *p = line; *p; p++)
+            if (*p == ',' || *p == ';')
+                *p = ' ';
+
+        unsigned long long time_us;
+        unsigned channel, level;
+        int fields = sscanf(line, "%llu %u %u", &time_us, &channel, &level);
+        if (fields <= 0)
+            continue;
+        if (fields != 3 || channel >= channels || level > 1)
+        {
+            fprintf(stderr, "%s:%u: linha inválida\n", path, line_number);
+            fclose(file);
+            return -1;
+        }
+        add_edge(time_us, channel, level);
+    }
+    fclose(file);
+    qsort(edges, edge_count, sizeof(edge_t), compare_edges);
+    return 0;
+}
+
+typedef struct expected_t
+{
+    uint32_t count;       // Pulsos válidos
+    uint32_t glitches;    // Pulsos mais curtos que o filtro
+    uint64_t on_us;       // Tempo ocupado (pulsos válidos)
+} expected_t;
+
+// Gera pulsos periódicos por canal, com fase inicial e jitter de período aleatórios.
+static void generate_edges(uint8_t channels, double rate_hz, double duty, uint32_t glitches_per_s,
+                           double seconds, uint32_t glitch_us, expected_t expected[])
+{
+    uint64_t end_us = (uint64_t)(seconds * 1e6);
+    for (uint8_t c = 0; c < channels; c++)
+    {
+        // Cada canal com uma frequência ligeiramente diferente, para não alinhar as bordas
+        double period_us = 1e6 / (rate_hz * (1.0 + 0.07 * c));
+        double t = period_us * rand() / RAND_MAX;
+        while (t + period_us < end_us)
+        {
+            double width = period_us * duty;
+            add_edge((uint64_t)t, c, 1);
+            add_edge((uint64_t)(t + width), c, 0);
+            expected[c].count++;
+            expected[c].on_us += (uint64_t)(t + width) - (uint64_t)t;
+
+            // Espúrio no meio do intervalo livre
+            if (glitches_per_s && rand() % 1000 < (int)(1000 * glitches_per_s / (rate_hz * (1.0 + 0.07 * c))))
+            {
+                double gap = period_us - width;
+                uint64_t at = (uint64_t)(t + width + gap / 2);
+                add_edge(at, c, 1);
+                add_edge(at + glitch_us, c, 0);
+                expected[c].glitches++;
+            }
+            t += period_us * (0.95 + 0.1 * rand() / RAND_MAX);
+        }
+    }
+    qsort(edges, edge_count, sizeof(edge_t), compare_edges);
+}
+
+static int write_edges(const char *path)
+{
+    FILE *file = fopen(path, "w");
+    if (!file)
+    {
+        perror(path);
+        return -1;
+    }
+    fprintf(file, "# tempo_us canal nivel\n");
+    for (size_t i = 0; i < edge_count; i++)
+        fprintf(file, "%llu %u %u\n", (unsigned long long)edges[i].time_us, edges[i].channel, edges[i].level);
+    fclose(file);
+    return 0;
+}
+
+// Amostra as bordas como a PIO: uma amostra a cada sample_us, empacotada da mais antiga para a mais nova.
+static uint32_t *sample_words(uint8_t channels, uint32_t sample_us, uint64_t end_us, size_t *word_count)
+{
+    uint8_t samples_per_word = 32 / channels;
+    uint64_t total_samples = end_us / sample_us + 1;
+    size_t count = (total_samples + samples_per_word - 1) / samples_per_word;
+    uint32_t *words = calloc(count, sizeof(uint32_t));
+    if (!words)
+    {
+        perror("calloc");
+        exit(1);
+    }
+
+    uint32_t levels = 0;
+    size_t next = 0;
+    for (size_t w = 0; w < count; w++)
+    {
+        uint32_t word = 0;
+        for (uint8_t k = 0; k < samples_per_word; k++)
+        {
+            uint64_t now_us = ((uint64_t)w * samples_per_word + k) * sample_us;
+            while (next < edge_count && edges[next].time_us <= now_us)
+            {
+                if (edges[next].level)
+                    levels |= 1u << edges[next].channel;
+                else
+                    levels &= ~(1u << edges[next].channel);
+                next++;
+            }
+            word = (word << channels) | levels;
+        }
+        words[w] = word;
+    }
+    *word_count = count;
+    return words;
+}
+
+static double now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(int argc, char **argv)
+{
+    const char *input = NULL, *output = NULL;
+    unsigned channels = 4, sample_us = 10, filter_us = 50, batch_ms = 20, glitches = 0;
+    double rate_hz = 1000, duty = 30, seconds = 10;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--file") && i + 1 < argc)
+            input = argv[++i];
+        else if (!strcmp(argv[i], "--write") && i + 1 < argc)
+            output = argv[++i];
+        else if (!strcmp(argv[i], "--channels") && i + 1 < argc)
+            channels = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--rate-hz") && i + 1 < argc)
+            rate_hz = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--duty") && i + 1 < argc)
+            duty = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--glitches") && i + 1 < argc)
+            glitches = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--seconds") && i + 1 < argc)
+            seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--sample-us") && i + 1 < argc)
+            sample_us = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--filter-us") && i + 1 < argc)
+            filter_us = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--batch-ms") && i + 1 < argc)
+            batch_ms = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "uso: %s [--file bordas.txt | --rate-hz F --duty %% --glitches N --seconds S "
+                            "--write bordas.txt] [--channels N] [--sample-us T] [--filter-us T] [--batch-ms T]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+
+    detector_core_t core;
+    detector_config_t config = {.channels = channels, .sample_us = sample_us, .filter_us = filter_us};
+    if (!detector_core_init(&core, &config))
+    {
+        fprintf(stderr, "configuração inválida: canais deve ser 1, 2, 4 ou 8\n");
+        return 2;
+    }
+
+    expected_t expected[DETECTOR_MAX_CHANNELS] = {0};
+    bool has_expected = input == NULL;
+    if (input)
+    {
+        if (load_edges(input, channels) < 0)
+            return 1;
+    }
+    else
+    {
+        srand(1);
+        // Espúrios com metade do filtro: sempre descartados
+        generate_edges(channels, rate_hz, duty / 100.0, glitches, seconds, filter_us / 2, expected);
+    }
+    if (output && write_edges(output) < 0)
+        return 1;
+
+    uint64_t end_us = edge_count ? edges[edge_count - 1].time_us + 1000 : 0;
+    size_t word_count;
+    uint32_t *words = sample_words(channels, sample_us, end_us, &word_count);
+
+    // Lotes do tamanho produzido pela captura em batch_ms, com variação de até ±50%
+    uint32_t batch_words = (uint32_t)((uint64_t)batch_ms * 1000 / sample_us / core.samples_per_word);
+    if (batch_words == 0)
+        batch_words = 1;
+    double start = now_ns();
+    for (size_t done = 0; done < word_count;)
+    {
+        uint32_t batch = batch_words / 2 + rand() % (batch_words + 1);
+        if (batch > word_count - done)
+            batch = word_count - done;
+        detector_core_process(&core, &words[done], batch);
+        done += batch;
+    }
+    double elapsed_ns = now_ns() - start;
+
+    printf("palavras;%zu;sem_bordas;%.1f%%;ns_por_palavra;%.1f;bordas_por_s;%.0f\n", word_count,
+           100.0 * core.quiet_words / word_count, elapsed_ns / word_count, edge_count / (end_us / 1e6));
+    printf("canal;veiculos;ocupacao;headway_medio_us;headway_min_us;descartados");
+    printf(has_expected ? ";esperado_veiculos;esperado_ocupacao;esperado_descartados\n" : "\n");
+
+    int failures = 0;
+    for (uint8_t c = 0; c < channels; c++)
+    {
+        detector_window_t window;
+        detector_core_read_window(&core, c, &window);
+        printf("%u;%u;%u.%u%%;%u;%u;%u", c, window.count, window.occupancy_permille / 10,
+               window.occupancy_permille % 10, window.mean_headway_us, window.min_headway_us, window.rejected);
+        if (has_expected)
+        {
+            uint32_t expected_permille = (uint32_t)(expected[c].on_us * 1000 / (core.sample * sample_us));
+            printf(";%u;%u.%u%%;%u", expected[c].count, expected_permille / 10, expected_permille % 10,
+                   expected[c].glitches);
+            // Ocupação quantizada pela amostragem: tolera 1 amostra por pulso
+            uint64_t tolerance = (uint64_t)expected[c].count * sample_us * 1000 / (core.sample * sample_us) + 1;
+            if (window.count != expected[c].count || window.rejected != expected[c].glitches ||
+                window.occupancy_permille + tolerance < expected_permille ||
+                window.occupancy_permille > expected_permille + tolerance)
+            {
+                printf(";DIVERGENTE");
+                failures++;
+            }
+        }
+        printf("\n");
+    }
+
+    free(words);
+    free(edges);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+"""Expande o log binário do semáforo em texto.
+
+Lê o fluxo da USB CDC (ou um arquivo gravado dele), reconhece os quadros
+binários do canal de log e os converte com os formatos de
+lib/log/log_messages.h. Bytes fora de quadros (relatórios em texto) são
+repassados sem alteração.
+
+Uso: tools/log_decode.py /dev/ttyACM0
+"""
+
+import argparse
+import pathlib
+import re
+import struct
+import sys
+
+FRAME_SYNC = 0xA5
+LOG_CHANNEL = 0x01
+MESSAGES_HEADER = pathlib.Path(__file__).resolve().parent.parent / "lib" / "log" / "log_messages.h"
+
+
+def load_formats(path):
+    """Retorna a lista de formatos na ordem da tabela LOG_MESSAGES."""
+    text = path.read_text(encoding="utf-8")
+    return [fmt for _, fmt in re.findall(r'X\((\w+),\s*"((?:[^"\\]|\\.)*)"\)', text)]
+
+
+def crc8(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def expand(formats, payload):
+    timestamp_us, message_id = struct.unpack_from("<IH", payload)
+    args = struct.unpack_from("<%dI" % ((len(payload) - 6) // 4), payload, 6)
+    if message_id >= len(formats):
+        return "%10.6f [id %d desconhecido] %s" % (timestamp_us / 1e6, message_id, args)
+    # %d é um argumento com sinal (complemento de dois em 32 bits); %u e %x são sem sinal.
+    conversions = re.findall(r"%l?([udx])", formats[message_id])
+    args = tuple(a - (1 << 32) if c == "d" and a >= 1 << 31 else a for c, a in zip(conversions, args))
+    text = re.sub(r"%l?[udx]", "%d", formats[message_id])
+    return "%10.6f %s" % (timestamp_us / 1e6, text % args)
+
+
+def decode(stream, formats, out, channel=LOG_CHANNEL):
+    buffer = bytearray()
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            break
+        buffer += chunk
+        while buffer:
+            if buffer[0] != FRAME_SYNC:
+                # Texto comum: repassa até o próximo byte de sincronismo
+                end = buffer.find(bytes([FRAME_SYNC]))
+                end = len(buffer) if end < 0 else end
+                out.write(buffer[:end].decode("utf-8", errors="replace"))
+                del buffer[:end]
+                continue
+            if len(buffer) < 3:
+                break
+            length = buffer[2]
+            if len(buffer) < 3 + length + 1:
+                break
+            payload = bytes(buffer[3:3 + length])
+            if crc8(payload) != buffer[3 + length] or length < 6:
+                out.write(chr(buffer[0]))  # Não era um quadro: trata como texto
+                del buffer[:1]
+                continue
+            if buffer[1] == channel:
+                out.write(expand(formats, payload) + "\n")
+            del buffer[:3 + length + 1]
+        out.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("source", help="porta serial (ex.: /dev/ttyACM0) ou arquivo gravado")
+    parser.add_argument("--messages", type=pathlib.Path, default=MESSAGES_HEADER,
+                        help="tabela de mensagens (padrão: lib/log/log_messages.h)")
+    args = parser.parse_args()
+
+    formats = load_formats(args.messages)
+    with open(args.source, "rb", buffering=0) as stream:
+        decode(stream, formats, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,190 @@
+#!/usr/bin/env python3
+"""Análise de tempo de resposta do plano de tarefas do semáforo.
+
+Lê a tabela TASK_TABLE de src/task_config.h, resolve as constantes pelos
+#define de src/ e lib/, atribui as prioridades por taxa monotônica com a
+mesma regra de src/main.c (menor período; empate pelo menor prazo efetivo
+e depois pela ordem da tabela) e calcula o pior tempo de resposta de cada
+tarefa:
+
+    R = C + B + soma(ceil(R / Tj) * Cj) sobre as tarefas de maior prioridade
+
+em que B é o maior bloqueio declarado por uma tarefa de menor prioridade.
+Como cada tarefa é um laço que só libera o próximo job ao fim do atual, o
+limite de cada tarefa é o menor entre o prazo e o período. Termina com
+código 1 se alguma tarefa passar do limite, o que interrompe o build.
+
+Com --relatorio, os orçamentos são substituídos pela coluna
+wcet_recomendado_us do relatório de prazos capturado da USB (execução
+máxima medida mais 25%), para conferir o plano com medições reais.
+
+Uso: tools/rta.py [--relatorio captura.txt]
+"""
+
+import argparse
+import math
+import pathlib
+import re
+import sys
+
+ROOT = pathlib.Path(__file__).resolve().parent.parent
+TASK_CONFIG = ROOT / "src" / "task_config.h"
+DEFINE_SOURCES = ("src/*.h", "src/*.c", "lib/**/*.h")
+FIELDS = ("id", "function", "name", "stack", "period_ms", "max_interval_ms", "wcet_us", "deadline_ms",
+          "blocking_us", "is_critical")
+
+
+def strip_comments(text):
+    text = re.sub(r"/\*.*?\*/", " ", text, flags=re.S)
+    return re.sub(r"//[^\n]*", "", text)
+
+
+def load_defines():
+    """Macros sem parâmetros de src/ e lib/: nome -> expressão (a primeira definição vale)."""
+    defines = {}
+    for pattern in DEFINE_SOURCES:
+        for path in sorted(ROOT.glob(pattern)):
+            text = strip_comments(path.read_text(encoding="utf-8", errors="replace").replace("\\\n", " "))
+            for name, value in re.findall(r"^\s*#\s*define\s+(\w+)(?!\()[ \t]+([^\n]+)", text, flags=re.M):
+                defines.setdefault(name, value.strip())
+    return defines
+
+
+def evaluate(expression, defines, depth=0):
+    """Avalia uma expressão inteira de C com as constantes resolvidas."""
+    if depth > 32:
+        raise ValueError("definição recursiva: %s" % expression)
+
+    def resolve(match):
+        word = match.group(0)
+        if word in ("true", "false"):
+            return "1" if word == "true" else "0"
+        if word not in defines:
+            raise ValueError("constante desconhecida: %s" % word)
+        return "(%d)" % evaluate(defines[word], defines, depth + 1)
+
+    text = re.sub(r"\b(\d+)[uUlL]*\b", r"\1", expression)             # Sufixos de literais
+    text = re.sub(r"\(\s*(?:u?int\d+_t|unsigned|int|uint)\s*\)", "", text)  # Conversões
+    text = re.sub(r"\b[A-Za-z_]\w*\b", resolve, text)
+    if not re.fullmatch(r"[\d\s()+\-*/%<>|&^~]*", text):
+        raise ValueError("expressão não suportada: %s" % expression)
+    return int(eval(text.replace("/", "//")))
+
+
+def split_arguments(text):
+    """Separa os argumentos de uma chamada nas vírgulas de nível zero."""
+    arguments, depth, current, quoted = [], 0, "", False
+    for char in text:
+        if char == '"':
+            quoted = not quoted
+        elif not quoted and char in "([":
+            depth += 1
+        elif not quoted and char in ")]":
+            depth -= 1
+        if char == "," and depth == 0 and not quoted:
+            arguments.append(current.strip())
+            current = ""
+        else:
+            current += char
+    arguments.append(current.strip())
+    return arguments
+
+
+def load_tasks(defines):
+    text = strip_comments(TASK_CONFIG.read_text(encoding="utf-8").replace("\\\n", " "))
+    table = re.search(r"#\s*define\s+TASK_TABLE\(X\)([^\n]*)", text)
+    if not table:
+        raise ValueError("TASK_TABLE não encontrada em %s" % TASK_CONFIG)
+
+    tasks = []
+    body = table.group(1)
+    for start in (m.end() for m in re.finditer(r"\bX\(", body)):
+        depth, end = 1, start
+        while depth:
+            depth += {"(": 1, ")": -1}.get(body[end], 0)
+            end += 1
+        task = dict(zip(FIELDS, split_arguments(body[start:end - 1])))
+        task["name"] = task["name"].strip('"')
+        for field in ("period_ms", "wcet_us", "deadline_ms", "blocking_us"):
+            task[field] = evaluate(task[field], defines)
+        task["index"] = len(tasks)
+        tasks.append(task)
+    return tasks
+
+
+def load_report(path):
+    """Último wcet_recomendado_us de cada tarefa em uma captura dos relatórios."""
+    measured, columns = {}, None
+    for line in pathlib.Path(path).read_text(encoding="utf-8", errors="replace").splitlines():
+        cells = line.strip().split(";")
+        if cells[0] == "tarefa" and "wcet_recomendado_us" in cells:
+            columns = cells
+        elif columns and len(cells) == len(columns):
+            measured[cells[0]] = int(cells[columns.index("wcet_recomendado_us")])
+        else:
+            columns = None
+    return measured
+
+
+def effective_deadline_ms(task):
+    return task["deadline_ms"] or task["period_ms"]
+
+
+def analyse(tasks):
+    """Ordena por prioridade e preenche o tempo de resposta e o limite de cada tarefa."""
+    ordered = sorted(tasks, key=lambda t: (t["period_ms"], effective_deadline_ms(t), t["index"]))
+    for rank, task in enumerate(ordered):
+        higher, lower = ordered[:rank], ordered[rank + 1:]
+        task["priority"] = len(ordered) - rank
+        task["blocking"] = max((t["blocking_us"] for t in lower), default=0)
+        task["limit_us"] = min(effective_deadline_ms(task), task["period_ms"]) * 1000
+
+        response = task["wcet_us"] + task["blocking"]
+        while True:
+            demand = task["wcet_us"] + task["blocking"] + sum(
+                math.ceil(response / (t["period_ms"] * 1000)) * t["wcet_us"] for t in higher)
+            if demand == response or demand > task["limit_us"]:
+                break
+            response = demand
+        task["response_us"] = demand
+    return ordered
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--relatorio", help="captura da USB com o relatório de prazos (WCET medido)")
+    args = parser.parse_args()
+
+    try:
+        tasks = load_tasks(load_defines())
+    except ValueError as error:
+        print("rta: %s" % error, file=sys.stderr)
+        return 2
+
+    if args.relatorio:
+        measured = load_report(args.relatorio)
+        for task in tasks:
+            task["wcet_us"] = measured.get(task["name"], task["wcet_us"])
+
+    ordered = analyse(tasks)
+    print("tarefa;prioridade;periodo_ms;prazo_ms;wcet_us;bloqueio_us;resposta_us;limite_us;escalonavel")
+    for task in ordered:
+        print("%s;%d;%d;%d;%d;%d;%d;%d;%s" % (
+            task["name"], task["priority"], task["period_ms"], task["deadline_ms"], task["wcet_us"],
+            task["blocking"], task["response_us"], task["limit_us"],
+            "sim" if task["response_us"] <= task["limit_us"] else "nao"))
+
+    utilization = sum(t["wcet_us"] / (t["period_ms"] * 1000) for t in tasks)
+    bound = len(tasks) * (2 ** (1 / len(tasks)) - 1)
+    print("# utilizacao %.1f%% (limite de Liu e Layland para %d tarefas: %.1f%%)"
+          % (utilization * 100, len(tasks), bound * 100))
+
+    failed = [t["name"] for t in ordered if t["response_us"] > t["limit_us"]]
+    if failed:
+        print("rta: conjunto de tarefas não escalonável: %s" % ", ".join(failed), file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,199 @@
+#!/usr/bin/env python3
+"""Cliente do fluxo binário de estado do semáforo.
+
+Assina tópicos pela USB CDC ("assinar <topico> [intervalo_ms]"), decodifica
+os quadros do canal de estado e imprime cada atualização. Antes de assinar,
+envia comandos "eco" para medir o atraso do enlace e alinhar o relógio do
+firmware ao do host pelo eco de menor ida e volta. Ao final, resume por
+tópico a taxa sustentada, os quadros perdidos (lacunas na sequência) e a
+latência ponta a ponta: da fronteira de fase, ou da codificação do quadro,
+até a leitura no host.
+
+Uso: tools/status_client.py /dev/ttyACM0 [--fase MS] [--saidas MS] [--estatisticas MS] [--duracao S]
+"""
+
+import argparse
+import os
+import select
+import struct
+import sys
+import termios
+import time
+import tty
+
+from log_decode import FRAME_SYNC, crc8
+
+STATUS_CHANNEL = 0x04
+HEADER = struct.Struct("<HBI")
+TOPICS = {0: "fase", 1: "saidas", 2: "estatisticas", 0xFF: "eco"}
+PAYLOADS = {
+    0: (struct.Struct("<IIBB"), ("sequencia", "fronteira_us", "estado", "modos")),
+    1: (struct.Struct("<BBHH"), ("leds", "matriz", "buzzer_a_hz", "buzzer_b_hz")),
+    2: (struct.Struct("<IIIII"), ("uptime_ms", "perdas", "pedestres", "latencia_max_ms", "veiculos")),
+    0xFF: (struct.Struct("<I"), ("eco",)),
+}
+FLAGS = ((1, "noturno"), (2, "falha"), (4, "atuado"), (8, "coordenado"), (16, "aceso"), (32, "adaptativo"))
+STATES = ("verde", "amarelo", "vermelho")
+
+
+class FrameReader:
+    """Separa os quadros de estado do fluxo, que também traz texto e outros canais."""
+
+    def __init__(self, fd):
+        self.fd = fd
+        self.buffer = bytearray()
+
+    def read(self, timeout):
+        """Retorna [(instante_host_us, carga_útil)] dos quadros completos recebidos até o timeout."""
+        frames = []
+        ready, _, _ = select.select([self.fd], [], [], timeout)
+        if not ready:
+            return frames
+        chunk = os.read(self.fd, 4096)
+        received_us = time.monotonic_ns() // 1000
+        self.buffer += chunk
+        while True:
+            start = self.buffer.find(bytes([FRAME_SYNC]))
+            if start < 0:
+                self.buffer.clear()
+                break
+            del self.buffer[:start]
+            if len(self.buffer) < 3 or len(self.buffer) < 3 + self.buffer[2] + 1:
+                break
+            channel, length = self.buffer[1], self.buffer[2]
+            payload = bytes(self.buffer[3:3 + length])
+            if crc8(payload) != self.buffer[3 + length]:
+                del self.buffer[:1]  # Byte de texto igual ao sincronismo
+                continue
+            del self.buffer[:3 + length + 1]
+            if channel == STATUS_CHANNEL and length >= HEADER.size:
+                frames.append((received_us, payload))
+        return frames
+
+
+def decode(payload):
+    sequence, topic, timestamp_us = HEADER.unpack_from(payload)
+    layout = PAYLOADS.get(topic)
+    if layout is None or len(payload) < HEADER.size + layout[0].size:
+        return sequence, topic, timestamp_us, {}
+    return sequence, topic, timestamp_us, dict(zip(layout[1], layout[0].unpack_from(payload, HEADER.size)))
+
+
+def describe(topic, fields):
+    if topic == 0:
+        modes = "+".join(name for bit, name in FLAGS if fields["modos"] & bit) or "normal"
+        state = STATES[fields["estado"]] if fields["estado"] < len(STATES) else fields["estado"]
+        return "fase %d %s (%s)" % (fields["sequencia"], state, modes)
+    return " ".join("%s=%d" % item for item in fields.items())
+
+
+class Clock:
+    """Converte instantes de 32 bits do firmware para o relógio do host."""
+
+    def __init__(self, device_us, host_us):
+        self.device_us = device_us
+        self.host_us = host_us
+
+    def to_host(self, device_us):
+        delta = (device_us - self.device_us) & 0xFFFFFFFF
+        if delta >= 1 << 31:
+            delta -= 1 << 32
+        return self.host_us + delta
+
+
+def synchronize(fd, reader, count):
+    """Mede a ida e volta dos ecos; alinha os relógios pelo eco mais rápido."""
+    best, round_trips = None, []
+    for token in range(count):
+        sent_us = time.monotonic_ns() // 1000
+        os.write(fd, b"eco %d\n" % token)
+        deadline = time.monotonic() + 0.5
+        while time.monotonic() < deadline:
+            for received_us, payload in reader.read(0.05):
+                _, topic, timestamp_us, fields = decode(payload)
+                if topic != 0xFF or fields.get("eco") != token:
+                    continue
+                round_trip = received_us - sent_us
+                round_trips.append(round_trip)
+                if best is None or round_trip < best[0]:
+                    best = (round_trip, Clock(timestamp_us, sent_us + round_trip // 2))
+                deadline = 0
+                break
+    if best is None:
+        raise SystemExit("sem resposta aos ecos: firmware sem o fluxo de estado ou porta errada")
+    return best[1], round_trips
+
+
+def percentile(values, fraction):
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(fraction * len(ordered)))]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("port", help="porta serial (ex.: /dev/ttyACM0)")
+    parser.add_argument("--fase", type=int, metavar="MS", help="assina as fases com este intervalo mínimo")
+    parser.add_argument("--saidas", type=int, metavar="MS", help="assina as saídas com este intervalo mínimo")
+    parser.add_argument("--estatisticas", type=int, metavar="MS", help="assina os contadores a cada intervalo")
+    parser.add_argument("--duracao", type=float, default=30, help="tempo de captura em segundos")
+    parser.add_argument("--ecos", type=int, default=20, help="ecos para medir o enlace")
+    parser.add_argument("--quieto", action="store_true", help="apenas o resumo")
+    args = parser.parse_args()
+
+    subscriptions = {name: getattr(args, name) for name in ("fase", "saidas", "estatisticas")}
+    if all(interval is None for interval in subscriptions.values()):
+        subscriptions = dict.fromkeys(subscriptions, 0)  # Sem opções: tudo na maior taxa
+
+    fd = os.open(args.port, os.O_RDWR | os.O_NOCTTY)
+    saved = termios.tcgetattr(fd) if os.isatty(fd) else None
+    try:
+        if saved:
+            tty.setraw(fd)
+        reader = FrameReader(fd)
+        clock, round_trips = synchronize(fd, reader, args.ecos)
+        for name, interval in subscriptions.items():
+            if interval is not None:
+                os.write(fd, b"assinar %s %d\n" % (name.encode(), interval))
+
+        counts, gaps, latencies, last_sequence = {}, 0, {}, None
+        start = time.monotonic()
+        while time.monotonic() - start < args.duracao:
+            for received_us, payload in reader.read(0.1):
+                sequence, topic, timestamp_us, fields = decode(payload)
+                if last_sequence is not None:
+                    gaps += (sequence - last_sequence - 1) & 0xFFFF
+                last_sequence = sequence
+                if topic == 0xFF:
+                    continue
+                name = TOPICS.get(topic, str(topic))
+                counts[name] = counts.get(name, 0) + 1
+                # A fase mede a partir da fronteira; os demais tópicos, a partir da codificação
+                event_us = fields["fronteira_us"] if topic == 0 else timestamp_us
+                latency = received_us - clock.to_host(event_us)
+                latencies.setdefault(name, []).append(latency)
+                if not args.quieto:
+                    print("%10.6f %s latencia %d us" % (timestamp_us / 1e6, describe(topic, fields), latency))
+    finally:
+        for name, interval in subscriptions.items():
+            if interval is not None:
+                os.write(fd, b"cancelar %s\n" % name.encode())
+        if saved:
+            termios.tcsetattr(fd, termios.TCSADRAIN, saved)
+        os.close(fd)
+
+    elapsed = time.monotonic() - start
+    print("# eco: ida e volta min %d us, mediana %d us, max %d us"
+          % (min(round_trips), percentile(round_trips, 0.5), max(round_trips)), file=sys.stderr)
+    print("topico;quadros;quadros_por_s;latencia_min_us;latencia_media_us;latencia_p99_us;latencia_max_us",
+          file=sys.stderr)
+    for name, values in latencies.items():
+        print("%s;%d;%.1f;%d;%d;%d;%d" % (name, counts[name], counts[name] / elapsed, min(values),
+                                           sum(values) // len(values), percentile(values, 0.99), max(values)),
+              file=sys.stderr)
+    total = sum(counts.values())
+    print("# total %d quadros em %.1f s: %.1f quadros/s sustentados, %d perdidos"
+          % (total, elapsed, total / elapsed, gaps), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,55 @@
+#!/usr/bin/env python3
+"""Tamanho, em bytes de flash, das funções com um prefixo no executável.
+
+Executa o nm do toolchain sobre o .elf e imprime, em ordem de tamanho, cada
+símbolo de código cujo nome começa com o prefixo. O build com HAL_BENCHMARK
+o chama após a ligação com o prefixo hal_bench_, e o resultado acompanha os
+ciclos por chamada que o firmware imprime no boot. Termina com código 1 se
+nenhum símbolo for encontrado (funções descartadas ou renomeadas).
+
+Uso: tools/symbol_sizes.py --nm arm-none-eabi-nm build/TrafficLight.elf hal_bench_
+"""
+
+import argparse
+import subprocess
+import sys
+
+
+def load_sizes(nm, elf, prefix):
+    """Símbolos de código (seção text) com o prefixo: nome -> tamanho em bytes."""
+    output = subprocess.run([nm, "--print-size", "--size-sort", elf], check=True, capture_output=True,
+                            text=True).stdout
+    sizes = {}
+    for line in output.splitlines():
+        fields = line.split()
+        if len(fields) != 4 or fields[2] not in "tT" or not fields[3].startswith(prefix):
+            continue
+        sizes[fields[3]] = int(fields[1], 16)
+    return sizes
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--nm", default="arm-none-eabi-nm", help="nm do toolchain")
+    parser.add_argument("elf", help="executável ligado")
+    parser.add_argument("prefix", help="prefixo dos símbolos")
+    args = parser.parse_args()
+
+    try:
+        sizes = load_sizes(args.nm, args.elf, args.prefix)
+    except (OSError, subprocess.CalledProcessError) as error:
+        print("symbol_sizes: %s" % error, file=sys.stderr)
+        return 2
+
+    if not sizes:
+        print("symbol_sizes: nenhum símbolo %s* em %s" % (args.prefix, args.elf), file=sys.stderr)
+        return 1
+
+    print("simbolo;bytes")
+    for name, size in sorted(sizes.items(), key=lambda item: (item[1], item[0])):
+        print("%s;%d" % (name, size))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())